@@ -0,0 +1,238 @@
+#include "Backtest.h"
+#include "Orderbook.h"
+#include "ThreadAffinity.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    // The journal split into per-instrument streams plus the session-wide commands every book sees.
+    //
+    // A serial replay hands every `AdvanceTime` to every book, which with thousands of instruments and a clock
+    // tick every few events would dwarf the real work. A book only needs time to be right when it next acts, and
+    // since a book never moves its clock backwards, the ticks between two of its own commands collapse into one
+    // move to the latest of them; only a "Good-For-Day" sweep in between has to be applied where it falls.
+    struct Partition
+    {
+        std::vector<std::vector<std::size_t>> instruments_; // Record positions of each instrument's own commands.
+        std::vector<InstrumentId> instrumentIds_;           // Instrument of each stream.
+        std::vector<std::size_t> sessionRecords_;           // Record positions of the session-wide commands.
+        std::vector<Timestamp> latestTime_;                 // Latest time among session-wide commands up to and including each one.
+        std::vector<std::size_t> sweeps_;                   // Positions in `sessionRecords_` of CancelGoodForDay commands.
+    };
+
+    Partition PartitionRecords(std::span<const JournalRecord> records)
+    {
+        Partition partition;
+        std::unordered_map<InstrumentId, std::size_t> streams;
+        auto latest = std::numeric_limits<Timestamp>::min();
+
+        for (std::size_t i = 0; i < records.size(); ++i)
+        {
+            const auto type = static_cast<CommandType>(records[i].type_);
+            if (type == CommandType::AdvanceTime || type == CommandType::CancelGoodForDay)
+            {
+                if (type == CommandType::AdvanceTime)
+                    latest = std::max(latest, records[i].timestamp_);
+                else
+                    partition.sweeps_.push_back(partition.sessionRecords_.size());
+
+                partition.sessionRecords_.push_back(i);
+                partition.latestTime_.push_back(latest);
+                continue;
+            }
+
+            const auto [stream, inserted] = streams.try_emplace(records[i].instrumentId_, partition.instruments_.size());
+            if (inserted)
+            {
+                partition.instruments_.emplace_back();
+                partition.instrumentIds_.push_back(records[i].instrumentId_);
+            }
+
+            partition.instruments_[stream->second].push_back(i);
+        }
+
+        return partition;
+    }
+
+    // Stamps each fill of the command being replayed.
+    class StampingSink final : public ExecutionSink
+    {
+    public:
+        StampingSink(InstrumentId instrumentId, std::vector<BacktestTrade>& trades)
+            : instrumentId_{ instrumentId }
+            , trades_{ trades }
+        { }
+
+        void OnTrade(const Trade& trade) override
+        {
+            trades_.push_back(BacktestTrade{ time_, sequence_, instrumentId_, trade.GetBidTrade(), trade.GetAskTrade() });
+        }
+
+        Timestamp time_{ std::numeric_limits<Timestamp>::min() };
+        std::uint64_t sequence_{ };
+
+    private:
+        InstrumentId instrumentId_;
+        std::vector<BacktestTrade>& trades_;
+    };
+
+    // Output of one instrument's replay.
+    struct StreamResult
+    {
+        std::vector<BacktestTrade> trades_;
+        std::size_t restingOrders_{ };
+    };
+
+    // Replays one instrument start to finish on the calling thread.
+    StreamResult ReplayStream(std::span<const JournalRecord> records, const Partition& partition, std::size_t stream,
+        const OrderbookConfig& config)
+    {
+        StreamResult result;
+        Orderbook orderbook{ config };
+        StampingSink sink{ partition.instrumentIds_[stream], result.trades_ };
+
+        std::size_t nextSession = 0; // First session-wide command not yet applied to this book.
+        auto applied = std::numeric_limits<Timestamp>::min();
+
+        auto AdvanceTo = [&](Timestamp now)
+        {
+            if (now <= applied)
+                return;
+
+            orderbook.AdvanceTime(now);
+            applied = now;
+        };
+
+        // Applies the session-wide commands before record `position`: each sweep at the time it saw, then the latest tick
+        auto CatchUp = [&](std::size_t position)
+        {
+            const auto& sessionRecords = partition.sessionRecords_;
+            const auto end = static_cast<std::size_t>(std::lower_bound(sessionRecords.begin() + nextSession, sessionRecords.end(), position) - sessionRecords.begin());
+            if (end == nextSession)
+                return;
+
+            const auto& sweeps = partition.sweeps_;
+            for (auto sweep = std::lower_bound(sweeps.begin(), sweeps.end(), nextSession); sweep != sweeps.end() && *sweep < end; ++sweep)
+            {
+                AdvanceTo(partition.latestTime_[*sweep]);
+                orderbook.CancelGoodForDayOrders();
+            }
+
+            AdvanceTo(partition.latestTime_[end - 1]);
+            nextSession = end;
+        };
+
+        for (const auto position : partition.instruments_[stream])
+        {
+            CatchUp(position);
+
+            const auto command = records[position].ToCommand();
+            sink.time_ = applied;
+            sink.sequence_ = records[position].sequence_;
+            orderbook.Execute(std::span{ &command, 1 }, sink);
+        }
+
+        // Whatever the journal did after this instrument's last command still applies to what is left resting
+        CatchUp(records.size());
+
+        result.restingOrders_ = orderbook.Size();
+        return result;
+    }
+}
+
+// Constructor: fixes the book options every instrument is replayed with
+Backtest::Backtest(BacktestConfig config)
+    : config_{ std::move(config) }
+{
+    config_.orderbook_.synchronization_ = Synchronization::SingleWriter;
+    config_.orderbook_.clock_ = nullptr;
+    config_.orderbook_.calendar_ = config_.calendar_;
+    config_.orderbook_.marketDataSink_ = nullptr;
+}
+
+// Function to replay a journal across the worker pool and merge the fills
+BacktestResult Backtest::Run(std::span<const JournalRecord> records) const
+{
+    const auto partition = PartitionRecords(records);
+    const auto streamCount = partition.instruments_.size();
+
+    // Claiming the longest streams first keeps one late, busy instrument from leaving the other workers idle at the end
+    std::vector<std::size_t> order(streamCount);
+    for (std::size_t i = 0; i < streamCount; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&partition](std::size_t left, std::size_t right)
+    {
+        return partition.instruments_[left].size() > partition.instruments_[right].size();
+    });
+
+    auto threadCount = config_.threadCount_ != 0 ? config_.threadCount_ : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    threadCount = std::min(threadCount, std::max<std::size_t>(streamCount, 1));
+
+    // Each stream writes only its own slot, so the workers share nothing but the claim counter
+    std::vector<StreamResult> results(streamCount);
+    std::vector<std::exception_ptr> errors(threadCount);
+    std::atomic<std::size_t> nextStream{ 0 };
+
+    auto Work = [&](std::size_t worker)
+    {
+        if (!config_.cpus_.empty())
+            PinCurrentThread(config_.cpus_[worker % config_.cpus_.size()]);
+
+        ORDERBOOK_TRY
+        {
+            for (auto claimed = nextStream.fetch_add(1, std::memory_order_relaxed); claimed < streamCount;
+                claimed = nextStream.fetch_add(1, std::memory_order_relaxed))
+                results[order[claimed]] = ReplayStream(records, partition, order[claimed], config_.orderbook_);
+        }
+        ORDERBOOK_CATCH_ALL
+        {
+            // Let the other workers run dry rather than start instruments whose output will be thrown away
+            nextStream.store(streamCount, std::memory_order_relaxed);
+            errors[worker] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i)
+        workers.emplace_back(Work, i);
+
+    for (auto& worker : workers)
+        worker.join();
+
+    for (const auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    // Merge the streams. Sequence numbers are unique per command and time never runs backwards along the journal,
+    // so the stable sort only has to keep each command's own fills in their matching order
+    BacktestResult result;
+    result.instruments_ = streamCount;
+    result.threads_ = threadCount;
+
+    std::size_t tradeCount = 0;
+    for (const auto& stream : results)
+        tradeCount += stream.trades_.size();
+
+    result.trades_.reserve(tradeCount);
+    for (auto& stream : results)
+    {
+        result.trades_.insert(result.trades_.end(), stream.trades_.begin(), stream.trades_.end());
+        result.restingOrders_ += stream.restingOrders_;
+    }
+
+    std::stable_sort(result.trades_.begin(), result.trades_.end(), [](const BacktestTrade& left, const BacktestTrade& right)
+    {
+        return left.time_ != right.time_ ? left.time_ < right.time_ : left.sequence_ < right.sequence_;
+    });
+
+    return result;
+}
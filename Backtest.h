@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Usings.h"
+#include "TradeInfo.h"
+#include "OrderbookConfig.h"
+#include "Journal.h"
+
+// One fill from a backtest, stamped with where it happened in the replayed flow.
+struct BacktestTrade
+{
+    Timestamp time_{ };            // Replayed time of the command that traded: the latest `AdvanceTime` before it.
+    std::uint64_t sequence_{ };    // Journal sequence of that command.
+    InstrumentId instrumentId_{ };
+    TradeInfo bid_{ };
+    TradeInfo ask_{ };
+};
+
+// What a backtest produced.
+struct BacktestResult
+{
+    std::vector<BacktestTrade> trades_; // Every fill, ordered by time, then journal sequence, then matching order.
+    std::size_t instruments_{ };        // Books the journal touched.
+    std::size_t threads_{ };            // Workers the run used.
+    std::size_t restingOrders_{ };      // Orders left resting across every book.
+};
+
+// Construction-time options for a `Backtest`.
+struct BacktestConfig
+{
+    std::size_t threadCount_{ 0 };      // Worker threads; zero uses one per hardware thread.
+    std::vector<int> cpus_;             // CPU to pin worker `i` to is `cpus_[i % size]`; empty leaves threads unpinned.
+    OrderbookConfig orderbook_{ };      // Options for every book; each is single-writer, replayed time replaces its clock, `calendar_` below replaces its calendar, and it publishes no market data.
+    // Session closes that expire "Good-For-Day" orders as replayed time passes them. Null leaves them to the journal's
+    // CancelGoodForDay sweeps. A fixed-UTC-offset `DailyCloseCalendar` or an `ExchangeCalendar` keeps the results the same on
+    // every machine; a local-time calendar would tie them to the time zone of the one running the backtest.
+    const SessionCalendar* calendar_{ nullptr };
+};
+
+// Replays a multi-instrument journal with one independent book per instrument, spread over a pool of threads.
+// Books share nothing, so each instrument is one task that a single worker replays start to finish without any
+// synchronization inside the book; idle workers claim the next unstarted instrument, largest first, until none are left.
+// Time comes only from the journal's `AdvanceTime` commands, so a run gives the same fills and the same timestamps
+// as replaying the whole journal in order on one thread, however many workers it uses.
+class Backtest
+{
+private:
+    BacktestConfig config_;
+
+public:
+    explicit Backtest(BacktestConfig config = { });
+
+    BacktestResult Run(std::span<const JournalRecord> records) const; // Throws if a worker's book throws or a record's order ID does not fit `OrderId`.
+    BacktestResult Run(const JournalReader& journal) const { return Run(journal.Records()); }
+};
@@ -0,0 +1,552 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Orderbook.h"
+#include "Journal.h"
+#include "Backtest.h"
+#include "LatencyHistogram.h"
+#include "PageMemory.h"
+
+// Benchmark driver for `make bench`. Without arguments it generates a reproducible synthetic order flow, fills the book
+// to a target depth, and times every call against it. Given `--journal` it replays a recorded journal instead,
+// so a baseline and a change can be compared on the same historical flow.
+//
+//   --operations N   measured operations (default 1000000)
+//   --depth N        resting orders to hold the book around (default 10000)
+//   --seed N         generator seed (default 42)
+//   --ladder         ladder price levels instead of the map
+//   --columnar       columnar order queues at each level
+//   --single-writer  skip the book's mutex
+//   --record PATH    also write the generated flow as a journal, for later `--journal` runs
+//   --journal PATH   replay this journal instead of generating a flow
+//   --threads N      with --journal: run it as a backtest on N worker threads, one book per instrument (0: one per core)
+//   --no-alloc       fail the synthetic run if its measured loop calls the global allocator at all
+//   --huge-pages     synthetic run: back the book with 2 MB pages
+//   --prefault       synthetic run: fault in the book's memory before the flow starts
+
+// Every call to the global allocator, so the synthetic run can report what its measured loop allocated
+namespace
+{
+    std::atomic<std::uint64_t> globalAllocations{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    globalAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1))
+        return memory;
+    Raise(std::bad_alloc{ });
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // The public calls the synthetic flow exercises.
+    enum class BenchOp
+    {
+        Add,
+        Cancel,
+        Modify,
+        Query,
+    };
+
+    constexpr const char* BenchOpNames[] = { "add", "cancel", "modify", "query" };
+    constexpr const char* CommandTypeNames[] = { "add", "cancel", "modify", "cancel-day", "advance-time" };
+
+    // Levels per side the full-depth query buffers are sized for; well beyond how far the synthetic flow spreads.
+    constexpr std::size_t QueryBufferLevels = 1024;
+
+    struct BenchStep
+    {
+        BenchOp op_;
+        Command command_;
+    };
+
+    struct BenchOptions
+    {
+        std::size_t operations_{ 1'000'000 };
+        std::size_t depth_{ 10'000 };
+        std::uint64_t seed_{ 42 };
+        bool ladder_{ false };
+        bool columnar_{ false };
+        bool singleWriter_{ false };
+        bool backtest_{ false };
+        bool noAlloc_{ false };
+        bool hugePages_{ false };
+        bool prefault_{ false };
+        std::size_t threads_{ 0 };
+        std::string record_;
+        std::string journal_;
+    };
+
+    // Counts fills and rejects without keeping them, so the timed loop never allocates for them.
+    class CountingSink final : public ExecutionSink
+    {
+    public:
+        void OnTrade(const Trade&) override { ++trades_; }
+        void OnReject(OrderId, RejectReason) override { ++rejects_; }
+
+        std::uint64_t trades_{ 0 };
+        std::uint64_t rejects_{ 0 };
+    };
+
+    // Synthetic order flow shaped like a liquid instrument: mostly passive adds clustered near the touch with a
+    // geometric tail, cancels of resting orders, some amends (about half of them quantity-down at the same price),
+    // a small share of aggressive orders of every type, a few icebergs showing one lot at a time, and occasional
+    // full-depth queries. The mid price drifts by single ticks, and the add/cancel balance leans towards whichever
+    // keeps the book near its target depth.
+    // A seed reproduces the same flow with the same standard library; `--record` pins it down across toolchains.
+    class OrderFlowGenerator
+    {
+    public:
+        OrderFlowGenerator(std::uint64_t seed, std::size_t depth)
+            : random_{ seed }
+            , depth_{ depth }
+        { }
+
+        // Passive adds that bring an empty book to the target depth.
+        std::vector<BenchStep> WarmUp()
+        {
+            std::vector<BenchStep> steps;
+            steps.reserve(depth_);
+            while (live_.size() < depth_)
+                steps.push_back(PassiveAdd());
+            return steps;
+        }
+
+        std::vector<BenchStep> Generate(std::size_t count)
+        {
+            std::vector<BenchStep> steps;
+            steps.reserve(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (Chance(1, 100))
+                    mid_ += Chance(1, 2) ? 1 : -1;
+
+                const auto roll = Uniform(100);
+                const std::uint64_t addShare = live_.size() < depth_ ? 50 : 38;
+
+                if (live_.empty() || roll < addShare)
+                    steps.push_back(Chance(1, 10) ? AggressiveAdd() : PassiveAdd());
+                else if (roll < 86)
+                    steps.push_back(Cancel());
+                else if (roll < 99)
+                    steps.push_back(Modify());
+                else
+                    steps.push_back(BenchStep{ BenchOp::Query, Command{ } });
+            }
+
+            return steps;
+        }
+
+    private:
+        struct LiveOrder
+        {
+            OrderId orderId_;
+            Side side_;
+            Price price_;
+            Quantity quantity_;
+        };
+
+        std::uint64_t Uniform(std::uint64_t bound) { return std::uniform_int_distribution<std::uint64_t>{ 0, bound - 1 }(random_); }
+        bool Chance(std::uint64_t numerator, std::uint64_t denominator) { return Uniform(denominator) < numerator; }
+        Price Distance(double p) { return static_cast<Price>(std::geometric_distribution<int>{ p }(random_)); }
+
+        // Round lots of 10 with a geometric size distribution.
+        Quantity Size() { return static_cast<Quantity>(10 * (1 + std::geometric_distribution<int>{ 0.3 }(random_))); }
+
+        BenchStep PassiveAdd()
+        {
+            const auto side = Chance(1, 2) ? Side::Buy : Side::Sell;
+            const auto price = side == Side::Buy ? mid_ - 1 - Distance(0.15) : mid_ + 1 + Distance(0.15);
+            const auto quantity = Size();
+            const auto type = Chance(1, 10) ? OrderType::GoodForDay : OrderType::GoodTillCancel;
+            const Quantity display = Chance(1, 20) ? 10 : 0;
+
+            live_.push_back(LiveOrder{ nextOrderId_, side, price, quantity });
+            return BenchStep{ BenchOp::Add, Command::Add(Order{ type, nextOrderId_++, side, price, quantity, 0, display }) };
+        }
+
+        BenchStep AggressiveAdd()
+        {
+            const auto side = Chance(1, 2) ? Side::Buy : Side::Sell;
+            const auto price = side == Side::Buy ? mid_ + Distance(0.5) : mid_ - Distance(0.5);
+            const auto quantity = Size();
+
+            const auto roll = Uniform(10);
+            if (roll == 0)
+                return BenchStep{ BenchOp::Add, Command::Add(Order{ nextOrderId_++, side, quantity }) };
+
+            const auto type = roll < 3 ? OrderType::FillAndKill : roll < 4 ? OrderType::FillOrKill : OrderType::GoodTillCancel;
+            return BenchStep{ BenchOp::Add, Command::Add(Order{ type, nextOrderId_++, side, price, quantity }) };
+        }
+
+        // Orders filled by aggressive flow stay in `live_`, so some cancels and amends miss, as they do in practice.
+        BenchStep Cancel()
+        {
+            const auto index = Uniform(live_.size());
+            const auto orderId = live_[index].orderId_;
+
+            live_[index] = live_.back();
+            live_.pop_back();
+            return BenchStep{ BenchOp::Cancel, Command::Cancel(orderId) };
+        }
+
+        BenchStep Modify()
+        {
+            auto& order = live_[Uniform(live_.size())];
+
+            if (Chance(1, 2) && order.quantity_ > 10)
+                order.quantity_ -= 10;
+            else
+            {
+                order.price_ = order.side_ == Side::Buy ? mid_ - 1 - Distance(0.15) : mid_ + 1 + Distance(0.15);
+                order.quantity_ = Size();
+            }
+
+            return BenchStep{ BenchOp::Modify, Command::Modify(OrderModify{ order.orderId_, order.side_, order.price_, order.quantity_ }) };
+        }
+
+        std::mt19937_64 random_;
+        std::size_t depth_;
+        Price mid_{ 10'000 };
+        OrderId nextOrderId_{ 1 };
+        std::vector<LiveOrder> live_;
+    };
+
+    OrderbookConfig MakeConfig(const BenchOptions& options)
+    {
+        OrderbookConfig config;
+        config.clock_ = nullptr; // Time only moves through journaled `AdvanceTime` commands
+        config.calendar_ = nullptr; // Sessions only close through journaled sweeps, as in a backtest, whatever the machine's time zone
+        config.latencyHistograms_ = true; // The run ends with the book's own histograms
+        if (options.singleWriter_)
+            config.synchronization_ = Synchronization::SingleWriter;
+        if (options.columnar_)
+            config.orderLayout_ = OrderLayout::Columnar;
+        if (options.ladder_)
+        {
+            config.levelStorage_ = LevelStorage::Ladder;
+            config.basePrice_ = 1;
+            config.levelCount_ = 1 << 16;
+        }
+        return config;
+    }
+
+    void Apply(Orderbook& orderbook, const BenchStep& step, CountingSink& sink, OrderbookLevelInfos& infos, std::uint64_t& levels)
+    {
+        switch (step.op_)
+        {
+        case BenchOp::Add:
+            orderbook.AddOrder(step.command_.ToOrder(), sink);
+            break;
+        case BenchOp::Cancel:
+            orderbook.CancelOrder(step.command_.orderId_);
+            break;
+        case BenchOp::Modify:
+            orderbook.ModifyOrder(step.command_.ToOrderModify(), sink);
+            break;
+        case BenchOp::Query:
+            orderbook.GetOrderInfos(infos);
+            levels += infos.GetBids().size() + infos.GetAsks().size();
+            break;
+        }
+    }
+
+    void PrintHeader()
+    {
+        std::printf("%-14s %10s %10s %8s %8s %8s %10s\n", "operation", "count", "mean(ns)", "p50", "p99", "p99.9", "max");
+    }
+
+    void PrintRow(const char* name, const LatencyHistogram& histogram)
+    {
+        if (histogram.Count() == 0)
+            return;
+
+        std::printf("%-14s %10llu %10.1f %8llu %8llu %8llu %10llu\n", name,
+            static_cast<unsigned long long>(histogram.Count()), histogram.Mean(),
+            static_cast<unsigned long long>(histogram.Percentile(50.0)),
+            static_cast<unsigned long long>(histogram.Percentile(99.0)),
+            static_cast<unsigned long long>(histogram.Percentile(99.9)),
+            static_cast<unsigned long long>(histogram.Max()));
+    }
+
+    // What the book holds per resting order: the record itself, and every byte it has allocated (pool slabs, ID index,
+    // expiry index and levels) spread over the orders resting at the end of the run.
+    void PrintMemory(const Orderbook& orderbook)
+    {
+        const auto bytes = orderbook.MemoryUsage();
+        const auto resting = orderbook.Size();
+        std::printf("memory: %zu-byte resting order, %zu bytes held, %.1f bytes per resting order\n", sizeof(RestingOrder), bytes,
+            resting != 0 ? static_cast<double>(bytes) / static_cast<double>(resting) : 0.0);
+    }
+
+    // The book's own histograms, covering warm-up and the measured run; empty when built with ORDERBOOK_STATS=0.
+    void PrintStats(const OrderbookStats& stats)
+    {
+        if (stats.addOrder_.Count() == 0)
+            return;
+
+        std::printf("book stats: %zu bid levels, %zu ask levels, order index load %.2f\n", stats.bidLevels_, stats.askLevels_,
+            stats.orderIndexLoadFactor_);
+        PrintHeader();
+        PrintRow("lock wait", stats.lockWait_);
+        PrintRow("add order", stats.addOrder_);
+        PrintRow("match orders", stats.matchOrders_);
+        PrintRow("cancel order", stats.cancelOrder_);
+        PrintRow("session sweep", stats.sessionSweep_);
+        PrintRow("fills/match", stats.matchDepth_);
+    }
+
+    void PrintThroughput(std::uint64_t operations, Clock::duration elapsed)
+    {
+        const auto seconds = std::chrono::duration<double>(elapsed).count();
+        std::printf("%llu operations in %.3f s: %.0f ops/s\n", static_cast<unsigned long long>(operations), seconds,
+            seconds > 0.0 ? static_cast<double>(operations) / seconds : 0.0);
+    }
+
+    // Function to time the synthetic flow against a book warmed up to the target depth
+    int RunSynthetic(const BenchOptions& options)
+    {
+        OrderFlowGenerator generator{ options.seed_, options.depth_ };
+        const auto warmUp = generator.WarmUp();
+        const auto steps = generator.Generate(options.operations_);
+
+        if (!options.record_.empty())
+        {
+            JournalWriter journal{ options.record_ };
+            for (const auto* flow : { &warmUp, &steps })
+                for (const auto& step : *flow)
+                    if (step.op_ != BenchOp::Query)
+                        journal.Append(step.command_);
+        }
+
+        // Page memory is only for the single synthetic book; it is not synchronized, so replay workers cannot share one
+        std::optional<PageMemory> memory;
+        auto config = MakeConfig(options);
+        if (options.hugePages_ || options.prefault_)
+            config.memory_ = &memory.emplace(PageMemoryConfig{ options.hugePages_ ? PageSize::Huge2MB : PageSize::Small, -1, options.prefault_ });
+
+        Orderbook orderbook{ config };
+        CountingSink sink;
+        std::uint64_t levels = 0;
+
+        // Size the query buffers as a long-running reader would have; the warmed-up book is more compact than
+        // the flow later spreads it, so sizing from it is not enough
+        LevelInfos bidBuffer;
+        LevelInfos askBuffer;
+        bidBuffer.reserve(QueryBufferLevels);
+        askBuffer.reserve(QueryBufferLevels);
+        OrderbookLevelInfos infos{ std::move(bidBuffer), std::move(askBuffer) };
+
+        for (const auto& step : warmUp)
+            Apply(orderbook, step, sink, infos, levels);
+        sink.trades_ = 0;
+        sink.rejects_ = 0;
+
+        LatencyHistogram histograms[std::size(BenchOpNames)];
+        LatencyHistogram total;
+
+        const auto allocationsBefore = globalAllocations.load(std::memory_order_relaxed);
+        const auto start = Clock::now();
+        for (const auto& step : steps)
+        {
+            const auto before = Clock::now();
+            Apply(orderbook, step, sink, infos, levels);
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count();
+
+            histograms[static_cast<std::size_t>(step.op_)].Record(static_cast<std::uint64_t>(latency));
+        }
+        const auto elapsed = Clock::now() - start;
+        const auto allocations = globalAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+        std::printf("synthetic flow: seed %llu, target depth %zu, %s levels%s%s%s%s\n", static_cast<unsigned long long>(options.seed_),
+            options.depth_, options.ladder_ ? "ladder" : "map", options.columnar_ ? ", columnar queues" : "", options.singleWriter_ ? ", single writer" : "",
+            options.hugePages_ ? (memory->HugePageFallbacks() != 0 ? ", transparent huge pages" : ", huge pages") : "", options.prefault_ ? ", pre-faulted" : "");
+        PrintThroughput(steps.size(), elapsed);
+        PrintHeader();
+        for (std::size_t i = 0; i < std::size(BenchOpNames); ++i)
+        {
+            PrintRow(BenchOpNames[i], histograms[i]);
+            total.Merge(histograms[i]);
+        }
+        PrintRow("all", total);
+        std::printf("trades %llu, rejects %llu, resting orders %zu, levels queried %llu\n", static_cast<unsigned long long>(sink.trades_),
+            static_cast<unsigned long long>(sink.rejects_), orderbook.Size(), static_cast<unsigned long long>(levels));
+        PrintMemory(orderbook);
+        PrintStats(orderbook.GetStats());
+
+        // Once warm, the book should serve the whole flow from its pools, arena and reused buffers
+        std::printf("global allocations in the measured loop: %llu\n", static_cast<unsigned long long>(allocations));
+        if (options.noAlloc_ && allocations != 0)
+        {
+            std::fprintf(stderr, "bench failed: the measured loop called the global allocator %llu times\n", static_cast<unsigned long long>(allocations));
+            return 1;
+        }
+        return 0;
+    }
+
+    // Function to time a recorded journal, one book per instrument, exactly as the engines applied it
+    int RunJournal(const BenchOptions& options)
+    {
+        const JournalReader journal{ options.journal_ };
+        const auto records = journal.Records();
+
+        std::vector<Command> commands;
+        commands.reserve(records.size());
+        for (const auto& record : records)
+            commands.push_back(record.ToCommand());
+
+        // Create every book up front so construction is not timed
+        std::map<InstrumentId, std::unique_ptr<Orderbook>> orderbooks;
+        for (const auto& command : commands)
+            if (command.type_ == CommandType::Add && orderbooks.find(command.instrumentId_) == orderbooks.end())
+                orderbooks.emplace(command.instrumentId_, std::make_unique<Orderbook>(MakeConfig(options)));
+
+        CountingSink sink;
+        LatencyHistogram histograms[std::size(CommandTypeNames)];
+        LatencyHistogram total;
+
+        const auto start = Clock::now();
+        for (const auto& command : commands)
+        {
+            const auto before = Clock::now();
+
+            // Session-wide commands reach every book, as they do in a sharded engine
+            if (command.type_ == CommandType::CancelGoodForDay || command.type_ == CommandType::AdvanceTime)
+            {
+                for (auto& [instrumentId, orderbook] : orderbooks)
+                    orderbook->Execute(std::span{ &command, 1 }, sink);
+            }
+            else if (const auto book = orderbooks.find(command.instrumentId_); book != orderbooks.end())
+                book->second->Execute(std::span{ &command, 1 }, sink);
+
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count();
+            histograms[static_cast<std::size_t>(command.type_)].Record(static_cast<std::uint64_t>(latency));
+        }
+        const auto elapsed = Clock::now() - start;
+
+        std::size_t resting = 0;
+        for (const auto& [instrumentId, orderbook] : orderbooks)
+            resting += orderbook->Size();
+
+        std::printf("journal replay: %s, %zu instruments, %s levels%s%s\n", options.journal_.c_str(), orderbooks.size(),
+            options.ladder_ ? "ladder" : "map", options.columnar_ ? ", columnar queues" : "", options.singleWriter_ ? ", single writer" : "");
+        PrintThroughput(commands.size(), elapsed);
+        PrintHeader();
+        for (std::size_t i = 0; i < std::size(CommandTypeNames); ++i)
+        {
+            PrintRow(CommandTypeNames[i], histograms[i]);
+            total.Merge(histograms[i]);
+        }
+        PrintRow("all", total);
+        std::printf("trades %llu, resting orders %zu\n", static_cast<unsigned long long>(sink.trades_), resting);
+        return 0;
+    }
+
+    int RunBacktest(const BenchOptions& options)
+    {
+        const JournalReader journal{ options.journal_ };
+
+        BacktestConfig config;
+        config.threadCount_ = options.threads_;
+        config.orderbook_ = MakeConfig(options);
+        const Backtest backtest{ config };
+
+        // The whole run is one measurement: partitioning, every instrument's replay and the merge of the fills
+        const auto start = Clock::now();
+        const auto result = backtest.Run(journal);
+        const auto elapsed = Clock::now() - start;
+
+        std::printf("journal backtest: %s, %zu instruments, %zu threads, %s levels%s\n", options.journal_.c_str(), result.instruments_,
+            result.threads_, options.ladder_ ? "ladder" : "map", options.columnar_ ? ", columnar queues" : "");
+        PrintThroughput(journal.Records().size(), elapsed);
+        std::printf("trades %zu, resting orders %zu\n", result.trades_.size(), result.restingOrders_);
+        return 0;
+    }
+
+    bool ParseOptions(int argc, char** argv, BenchOptions& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+
+            if (std::strcmp(argv[i], "--ladder") == 0)
+                options.ladder_ = true;
+            else if (std::strcmp(argv[i], "--columnar") == 0)
+                options.columnar_ = true;
+            else if (std::strcmp(argv[i], "--single-writer") == 0)
+                options.singleWriter_ = true;
+            else if (std::strcmp(argv[i], "--no-alloc") == 0)
+                options.noAlloc_ = true;
+            else if (std::strcmp(argv[i], "--huge-pages") == 0)
+                options.hugePages_ = true;
+            else if (std::strcmp(argv[i], "--prefault") == 0)
+                options.prefault_ = true;
+            else if (std::strcmp(argv[i], "--operations") == 0 && hasValue)
+                options.operations_ = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--depth") == 0 && hasValue)
+                options.depth_ = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+                options.seed_ = std::strtoull(argv[++i], nullptr, 10);
+            else if (std::strcmp(argv[i], "--record") == 0 && hasValue)
+                options.record_ = argv[++i];
+            else if (std::strcmp(argv[i], "--journal") == 0 && hasValue)
+                options.journal_ = argv[++i];
+            else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+            {
+                options.backtest_ = true;
+                options.threads_ = std::strtoull(argv[++i], nullptr, 10);
+            }
+            else
+                return false;
+        }
+
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "usage: %s [--operations N] [--depth N] [--seed N] [--ladder] [--columnar] [--single-writer] [--no-alloc] "
+            "[--record PATH | --journal PATH [--threads N]]\n", argv[0]);
+        return 2;
+    }
+
+#if defined(__cpp_exceptions)
+    try
+#endif
+    {
+        if (options.journal_.empty())
+            return RunSynthetic(options);
+
+        return options.backtest_ ? RunBacktest(options) : RunJournal(options);
+    }
+#if defined(__cpp_exceptions)
+    catch (const std::exception& error)
+    {
+        std::fprintf(stderr, "bench failed: %s\n", error.what());
+        return 1;
+    }
+#endif
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "LevelInfo.h"
+
+// Top of book. A side with no resting orders is reported with zero quantity.
+struct BestBidOffer
+{
+    LevelInfo bid_{ };
+    LevelInfo ask_{ };
+
+    bool HasBid() const { return bid_.quantity_ != 0; }
+    bool HasAsk() const { return ask_.quantity_ != 0; }
+
+    bool operator==(const BestBidOffer& other) const
+    {
+        return bid_.price_ == other.bid_.price_ && bid_.quantity_ == other.bid_.quantity_ &&
+            ask_.price_ == other.ask_.price_ && ask_.quantity_ == other.ask_.quantity_;
+    }
+};
+
+// Number of levels `Orderbook::GetDepth` wrote for each side.
+struct DepthCount
+{
+    std::size_t bids_{ };
+    std::size_t asks_{ };
+};
+
+// The top levels and overall shape of a book as last published for lock-free readers by `Orderbook::GetPublishedDepth`.
+// Everything in one copy was taken after the same mutation, so the levels, counts and totals always agree.
+struct DepthSnapshot
+{
+    static constexpr std::size_t MaxLevels = 16;
+
+    std::uint64_t version_{ };     // Times the book has published a changed snapshot; zero before the first.
+    std::size_t restingOrders_{ }; // Orders in the book.
+    std::size_t bidLevels_{ };     // Non-empty bid levels, including those beyond `bids_`.
+    std::size_t askLevels_{ };     // Non-empty ask levels, including those beyond `asks_`.
+    std::uint64_t bidQuantity_{ }; // Resting quantity over every bid level.
+    std::uint64_t askQuantity_{ }; // Resting quantity over every ask level.
+    std::size_t bidDepth_{ };      // Levels filled in `bids_`, best first.
+    std::size_t askDepth_{ };      // Levels filled in `asks_`, best first.
+    std::array<LevelInfo, MaxLevels> bids_{ };
+    std::array<LevelInfo, MaxLevels> asks_{ };
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Usings.h"
+#include "Side.h"
+#include "OrderType.h"
+#include "Order.h"
+#include "OrderModify.h"
+
+// The kinds of requests an engine thread can be asked to apply to its book.
+enum class CommandType
+{
+    Add,
+    Cancel,
+    Modify,
+    CancelGoodForDay,
+    AdvanceTime,
+};
+
+// A fixed-size, trivially copyable request that can travel through a ring buffer.
+struct Command
+{
+    CommandType type_{ CommandType::Cancel };
+    OrderType orderType_{ OrderType::GoodTillCancel };
+    Side side_{ Side::Buy };
+    InstrumentId instrumentId_{ }; // Book the command is routed to; ignored by a single-book engine.
+    OrderId orderId_{ };
+    Price price_{ };
+    Quantity quantity_{ };
+    Timestamp timestamp_{ }; // Add: GoodTillDate expiry. AdvanceTime: the current time.
+    Quantity displayQuantity_{ }; // Add: the slice an iceberg order shows; zero shows everything.
+
+    static Command Add(const Order& order, InstrumentId instrumentId = { })
+    {
+        return Command{ CommandType::Add, order.GetOrderType(), order.GetSide(), instrumentId, order.GetOrderId(), order.GetPrice(),
+            order.GetInitialQuantity(), order.GetExpiry(), order.GetDisplayQuantity() };
+    }
+
+    static Command Cancel(OrderId orderId, InstrumentId instrumentId = { })
+    {
+        return Command{ CommandType::Cancel, OrderType::GoodTillCancel, Side::Buy, instrumentId, orderId, Price{ }, Quantity{ } };
+    }
+
+    static Command Modify(const OrderModify& order, InstrumentId instrumentId = { })
+    {
+        return Command{ CommandType::Modify, OrderType::GoodTillCancel, order.GetSide(), instrumentId, order.GetOrderId(), order.GetPrice(), order.GetQuantity() };
+    }
+
+    // Cancels every "Good-For-Day" order; a sharded engine applies it to all of its books.
+    static Command CancelGoodForDay()
+    {
+        return Command{ CommandType::CancelGoodForDay, OrderType::GoodForDay, Side::Buy, InstrumentId{ }, OrderId{ }, Price{ }, Quantity{ } };
+    }
+
+    // Moves the book's time to `now`, expiring whatever is due; a sharded engine applies it to all of its books.
+    // This is how a replay drives time from the timestamps of its events.
+    static Command AdvanceTime(Timestamp now)
+    {
+        return Command{ CommandType::AdvanceTime, OrderType::GoodTillDate, Side::Buy, InstrumentId{ }, OrderId{ }, Price{ }, Quantity{ }, now };
+    }
+
+    Order ToOrder() const { return Order{ orderType_, orderId_, side_, price_, quantity_, timestamp_, displayQuantity_ }; }
+    OrderModify ToOrderModify() const { return OrderModify{ orderId_, side_, price_, quantity_ }; }
+};
@@ -0,0 +1,216 @@
+#include "ConsolidatedBook.h"
+#include "Failure.h"
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+
+// Constructor: creates one sink per venue
+ConsolidatedBook::ConsolidatedBook(const ConsolidatedBookConfig& config)
+    : venueCount_{ config.venueCount_ }
+    , publishedDepth_{ std::min(config.publishedDepth_, ConsolidatedDepth::MaxLevels) }
+    , synchronization_{ config.synchronization_ }
+    , bids_{ &arena_ }
+    , asks_{ &arena_ }
+{
+    if (venueCount_ == 0 || venueCount_ > ConsolidatedLevel::MaxVenues)
+        Raise(std::invalid_argument(std::format("A consolidated book takes 1 to {} venues, not {}.", ConsolidatedLevel::MaxVenues, venueCount_)));
+
+    feeds_.reserve(venueCount_);
+    for (VenueId venue = 0; venue < venueCount_; ++venue)
+        feeds_.emplace_back(*this, venue);
+}
+
+// Function to take the lock when venue books may update from several threads
+std::unique_lock<std::mutex> ConsolidatedBook::Lock() const
+{
+    if (synchronization_ == Synchronization::SingleWriter)
+        return { };
+
+    return std::unique_lock{ mutex_ };
+}
+
+// Function to hand out the sink a venue's book reports its deltas to
+MarketDataSink* ConsolidatedBook::VenueSink(VenueId venue)
+{
+    if (venue >= venueCount_)
+        Raise(std::out_of_range(std::format("Venue ({}) is not one of this book's {} venues.", venue, venueCount_)));
+
+    return &feeds_[venue];
+}
+
+// Function to apply a delta that did not come through a venue sink
+void ConsolidatedBook::Apply(VenueId venue, const LevelUpdate& update)
+{
+    if (venue >= venueCount_)
+        Raise(std::out_of_range(std::format("Venue ({}) is not one of this book's {} venues.", venue, venueCount_)));
+
+    ApplyUpdate(venue, update);
+}
+
+// Function to lock the book and apply one venue's delta to the side it belongs to
+void ConsolidatedBook::ApplyUpdate(VenueId venue, const LevelUpdate& update)
+{
+    auto lock = Lock();
+
+    if (update.side_ == Side::Buy)
+        ApplySide(bids_, venue, update);
+    else
+        ApplySide(asks_, venue, update);
+}
+
+// Function to swap a venue's share of one level for its new state, republishing only if the top of the side moved
+template<typename Compare>
+void ConsolidatedBook::ApplySide(Levels<Compare>& levels, VenueId venue, const LevelUpdate& update)
+{
+    // Whether the level is at or ahead of the best, or of the last published level, is decided before it changes,
+    // since a level that empties is gone afterwards
+    const auto better = levels.key_comp();
+    const bool touchesBest = levels.empty() || !better(levels.begin()->first, update.price_);
+    const bool touchesDepth = publishedDepth_ != 0
+        && (levels.size() <= publishedDepth_ || !better(std::next(levels.begin(), publishedDepth_ - 1)->first, update.price_));
+
+    auto found = levels.find(update.price_);
+    if (found == levels.end())
+    {
+        // A venue emptying a level it never reported, e.g. one that was cleared, changes nothing
+        if (update.quantity_ == 0)
+            return;
+
+        found = levels.emplace(update.price_, ConsolidatedLevel{ update.price_ }).first;
+    }
+
+    auto& level = found->second;
+    auto& share = level.venues_[venue];
+    level.quantity_ = level.quantity_ - share.quantity_ + update.quantity_;
+    level.count_ = level.count_ - share.count_ + update.count_;
+    share = VenueLevel{ update.quantity_, update.count_ };
+
+    if (level.quantity_ == 0)
+        levels.erase(found);
+
+    if (touchesBest)
+        UpdateTopOfBook();
+    if (touchesDepth)
+        UpdateDepthOfBook();
+}
+
+// Function to take a venue out of every level it is in
+void ConsolidatedBook::ClearVenue(VenueId venue)
+{
+    if (venue >= venueCount_)
+        Raise(std::out_of_range(std::format("Venue ({}) is not one of this book's {} venues.", venue, venueCount_)));
+
+    auto lock = Lock();
+
+    auto ClearSide = [venue](auto& levels)
+    {
+        for (auto level = levels.begin(); level != levels.end();)
+        {
+            auto& share = level->second.venues_[venue];
+            level->second.quantity_ -= share.quantity_;
+            level->second.count_ -= share.count_;
+            share = VenueLevel{ };
+
+            level = level->second.quantity_ == 0 ? levels.erase(level) : std::next(level);
+        }
+    };
+
+    ClearSide(bids_);
+    ClearSide(asks_);
+    UpdateTopOfBook();
+    UpdateDepthOfBook();
+}
+
+// Function to republish the consolidated BBO if it changed
+void ConsolidatedBook::UpdateTopOfBook()
+{
+    ConsolidatedBestBidOffer topOfBook;
+
+    if (!bids_.empty())
+        topOfBook.bid_ = bids_.begin()->second;
+
+    if (!asks_.empty())
+        topOfBook.ask_ = asks_.begin()->second;
+
+    // Readers only see a new sequence when something they care about moved
+    if (topOfBook != topOfBook_)
+    {
+        topOfBook_ = topOfBook;
+        publishedTopOfBook_.Store(topOfBook);
+    }
+}
+
+// Function to republish the consolidated top levels if they changed
+void ConsolidatedBook::UpdateDepthOfBook()
+{
+    if (publishedDepth_ == 0)
+        return;
+
+    ConsolidatedDepth depth;
+
+    // Only the top levels are walked, however many prices the venues quote
+    auto CopyLevels = [this](const auto& levels, std::array<ConsolidatedLevel, ConsolidatedDepth::MaxLevels>& buffer)
+    {
+        std::size_t count = 0;
+        for (const auto& [price, level] : levels)
+        {
+            if (count == publishedDepth_)
+                break;
+
+            buffer[count++] = level;
+        }
+
+        return count;
+    };
+
+    depth.bidDepth_ = CopyLevels(bids_, depth.bids_);
+    depth.askDepth_ = CopyLevels(asks_, depth.asks_);
+
+    if (depth.bidDepth_ == depthOfBook_.bidDepth_ && depth.askDepth_ == depthOfBook_.askDepth_
+        && std::equal(depth.bids_.begin(), depth.bids_.begin() + depth.bidDepth_, depthOfBook_.bids_.begin())
+        && std::equal(depth.asks_.begin(), depth.asks_.begin() + depth.askDepth_, depthOfBook_.asks_.begin()))
+        return;
+
+    depth.version_ = depthOfBook_.version_ + 1;
+    depthOfBook_ = depth;
+    publishedDepthOfBook_.Store(depth);
+}
+
+// Function to read the published consolidated BBO from any thread
+ConsolidatedBestBidOffer ConsolidatedBook::GetBestBidOffer() const
+{
+    return publishedTopOfBook_.Load();
+}
+
+// Function to read the published consolidated depth from any thread
+ConsolidatedDepth ConsolidatedBook::GetPublishedDepth() const
+{
+    return publishedDepthOfBook_.Load();
+}
+
+// Function to copy the top levels of each side, with each venue's share
+DepthCount ConsolidatedBook::GetDepth(std::size_t levels, std::span<ConsolidatedLevel> bids, std::span<ConsolidatedLevel> asks) const
+{
+    // The critical section is bounded by the requested depth, not by how many prices the venues quote
+    auto lock = Lock();
+
+    auto CopyLevels = [levels](const auto& side, std::span<ConsolidatedLevel> buffer)
+    {
+        const auto limit = std::min(levels, buffer.size());
+        std::size_t count = 0;
+
+        for (const auto& [price, level] : side)
+        {
+            if (count == limit)
+                break;
+
+            buffer[count++] = level;
+        }
+
+        return count;
+    };
+
+    return DepthCount{ CopyLevels(bids_, bids), CopyLevels(asks_, asks) };
+}
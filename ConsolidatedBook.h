@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "Usings.h"
+#include "Side.h"
+#include "LevelUpdate.h"
+#include "MarketDataSink.h"
+#include "BestBidOffer.h"
+#include "OrderbookConfig.h"
+#include "Seqlock.h"
+
+// Names one venue book feeding a `ConsolidatedBook`, counting from 0.
+using VenueId = std::uint32_t;
+
+// One venue's share of a consolidated price level.
+struct VenueLevel
+{
+    Quantity quantity_{ };
+    Quantity count_{ };
+
+    bool operator==(const VenueLevel&) const = default;
+};
+
+// A price level summed over every venue, with each venue's share; venues with nothing at the price show zero.
+struct ConsolidatedLevel
+{
+    static constexpr std::size_t MaxVenues = 16;
+
+    Price price_{ };
+    std::uint64_t quantity_{ }; // Sum of the venues' quantities, wide enough that it cannot wrap to zero on a populated level.
+    std::uint64_t count_{ };    // Sum of the venues' order counts, just as wide.
+    std::array<VenueLevel, MaxVenues> venues_{ };
+
+    bool operator==(const ConsolidatedLevel&) const = default;
+};
+
+// Consolidated best bid and offer. A side no venue quotes is reported with zero quantity.
+struct ConsolidatedBestBidOffer
+{
+    ConsolidatedLevel bid_{ };
+    ConsolidatedLevel ask_{ };
+
+    bool HasBid() const { return bid_.quantity_ != 0; }
+    bool HasAsk() const { return ask_.quantity_ != 0; }
+
+    bool operator==(const ConsolidatedBestBidOffer&) const = default;
+};
+
+// The consolidated top levels as last published for lock-free readers by `ConsolidatedBook::GetPublishedDepth`.
+struct ConsolidatedDepth
+{
+    static constexpr std::size_t MaxLevels = 8;
+
+    std::uint64_t version_{ }; // Times a changed view has been published; zero before the first.
+    std::size_t bidDepth_{ };  // Levels filled in `bids_`, best first.
+    std::size_t askDepth_{ };  // Levels filled in `asks_`, best first.
+    std::array<ConsolidatedLevel, MaxLevels> bids_{ };
+    std::array<ConsolidatedLevel, MaxLevels> asks_{ };
+};
+
+// Construction-time options for a `ConsolidatedBook`.
+struct ConsolidatedBookConfig
+{
+    std::size_t venueCount_{ 1 };     // Venue books feeding in, up to `ConsolidatedLevel::MaxVenues`.
+    std::size_t publishedDepth_{ 0 }; // Levels per side republished for `GetPublishedDepth`, up to `ConsolidatedDepth::MaxLevels`; 0 publishes nothing.
+    Synchronization synchronization_{ Synchronization::Locked }; // Single-writer only if every venue book updates on one thread.
+};
+
+// One instrument traded on several venues, merged from each venue book's L2 delta stream.
+// Each venue book gets the sink from `VenueSink` as its `OrderbookConfig::marketDataSink_`, and every delta updates
+// one merged level in place, so nothing is ever rebuilt from full depth. Levels remember each venue's share for
+// routing. The consolidated BBO, and optionally the top levels, are republished through seqlocks whenever a
+// delta changes them, so any thread reads the BBO in constant time without a lock.
+class ConsolidatedBook
+{
+private:
+    // Tags one venue book's deltas with its venue.
+    class VenueFeed final : public MarketDataSink
+    {
+    public:
+        VenueFeed(ConsolidatedBook& book, VenueId venue) : book_{ &book }, venue_{ venue } { }
+
+        void OnLevelUpdate(const LevelUpdate& update) override { book_->ApplyUpdate(venue_, update); }
+
+    private:
+        ConsolidatedBook* book_;
+        VenueId venue_;
+    };
+
+    template<typename Compare>
+    using Levels = std::pmr::map<Price, ConsolidatedLevel, Compare>;
+
+    std::size_t venueCount_;
+    std::size_t publishedDepth_; // Levels per side kept in `publishedDepthOfBook_`; zero when it is not maintained.
+    Synchronization synchronization_;
+    std::vector<VenueFeed> feeds_; // One sink per venue.
+    std::pmr::unsynchronized_pool_resource arena_; // Recycles level nodes as prices come and go.
+    Levels<std::greater<Price>> bids_; // Best (highest) price first.
+    Levels<std::less<Price>> asks_; // Best (lowest) price first.
+    ConsolidatedBestBidOffer topOfBook_{ }; // Writer's copy of the consolidated BBO.
+    Seqlock<ConsolidatedBestBidOffer> publishedTopOfBook_; // Consolidated BBO as seen by lock-free readers.
+    ConsolidatedDepth depthOfBook_{ }; // Writer's copy of the latest published depth.
+    Seqlock<ConsolidatedDepth> publishedDepthOfBook_; // Consolidated depth as seen by lock-free readers.
+    mutable std::mutex mutex_; // Serializes venue books that update from different threads.
+
+    std::unique_lock<std::mutex> Lock() const; // Locks `mutex_` unless the book is single-writer.
+    void ApplyUpdate(VenueId venue, const LevelUpdate& update); // Applies one delta from a known venue; takes the lock itself.
+    template<typename Compare>
+    void ApplySide(Levels<Compare>& levels, VenueId venue, const LevelUpdate& update); // Applies one delta and republishes what it changed.
+    void UpdateTopOfBook(); // Republishes the BBO if it changed.
+    void UpdateDepthOfBook(); // Republishes the top levels if they changed.
+
+public:
+    explicit ConsolidatedBook(const ConsolidatedBookConfig& config); // Throws std::invalid_argument for too many venues.
+    ConsolidatedBook(const ConsolidatedBook&) = delete;
+    void operator=(const ConsolidatedBook&) = delete;
+    ConsolidatedBook(ConsolidatedBook&&) = delete;
+    void operator=(ConsolidatedBook&&) = delete;
+
+    MarketDataSink* VenueSink(VenueId venue); // The sink to give that venue's book; it must not outlive this book.
+    void Apply(VenueId venue, const LevelUpdate& update); // Feeds one delta directly, e.g. decoded from a venue's wire feed.
+    void ClearVenue(VenueId venue); // Drops everything a venue contributed, e.g. before its book is rebuilt after a gap.
+
+    std::size_t VenueCount() const { return venueCount_; }
+    ConsolidatedBestBidOffer GetBestBidOffer() const; // Lock-free, constant-time read of the consolidated BBO.
+    ConsolidatedDepth GetPublishedDepth() const; // Lock-free read of the top `ConsolidatedBookConfig::publishedDepth_` levels.
+    DepthCount GetDepth(std::size_t levels, std::span<ConsolidatedLevel> bids, std::span<ConsolidatedLevel> asks) const; // Copies the top `levels` of each side.
+};
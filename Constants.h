@@ -1,10 +1,12 @@
 #pragma once
 
 #include <limits>
+#include <cstddef>
 
 #include "Usings.h"
 
 struct Constants
 {
     static const Price InvalidPrice = std::numeric_limits<Price>::quiet_NaN();
+    static constexpr std::size_t CacheLineSize = 64; // Alignment that keeps independently written fields off each other's lines.
 };
\ No newline at end of file
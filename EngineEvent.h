@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Usings.h"
+#include "Trade.h"
+#include "Command.h"
+#include "RejectReason.h"
+
+enum class EngineEventType
+{
+    Trade,  // A fill produced while applying a command.
+    Reject, // The book turned the command away; precedes its ack. A command for an unknown instrument gets a reject instead of an ack.
+    Ack,    // The command has been fully applied; follows any trades or reject it produced.
+};
+
+// A fixed-size, trivially copyable engine output that can travel through a ring buffer.
+struct EngineEvent
+{
+    EngineEventType type_{ EngineEventType::Ack };
+    CommandType command_{ CommandType::Add }; // Ack only: the command that was applied.
+    InstrumentId instrumentId_{ };            // Book the event came from.
+    OrderId orderId_{ };                      // Ack and Reject only: the order the command referred to.
+    RejectReason reject_{ };                  // Reject only.
+    TradeInfo bidTrade_{ };                   // Trade only.
+    TradeInfo askTrade_{ };                   // Trade only.
+
+    static EngineEvent FromTrade(const Trade& trade, InstrumentId instrumentId = { })
+    {
+        return EngineEvent{ EngineEventType::Trade, CommandType::Add, instrumentId, OrderId{ }, RejectReason{ }, trade.GetBidTrade(), trade.GetAskTrade() };
+    }
+
+    static EngineEvent FromReject(OrderId orderId, RejectReason reason, InstrumentId instrumentId = { })
+    {
+        return EngineEvent{ EngineEventType::Reject, CommandType::Add, instrumentId, orderId, reason, TradeInfo{ }, TradeInfo{ } };
+    }
+
+    static EngineEvent Ack(const Command& command)
+    {
+        return EngineEvent{ EngineEventType::Ack, command.type_, command.instrumentId_, command.orderId_, RejectReason{ }, TradeInfo{ }, TradeInfo{ } };
+    }
+
+    Trade ToTrade() const { return Trade{ bidTrade_, askTrade_ }; }
+};
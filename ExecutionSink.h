@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Trade.h"
+#include "RejectReason.h"
+
+// Receives execution reports from an order book at the moment each fill or reject happens.
+// Implementations can serialize straight into their own send buffers; the book never allocates
+// on their behalf.
+class ExecutionSink
+{
+public:
+    virtual ~ExecutionSink() = default;
+
+    virtual void OnTrade(const Trade& trade) = 0; // Called once per fill, in matching order.
+    virtual void OnReject(OrderId, RejectReason) { } // Called once per request the book turned away; ignored by default.
+};
+
+// Adapter that appends every fill to a `Trades` vector, for callers that want the results by value.
+class TradeCollector final : public ExecutionSink
+{
+public:
+    explicit TradeCollector(Trades& trades) : trades_{ trades } { }
+
+    void OnTrade(const Trade& trade) override { trades_.push_back(trade); }
+
+private:
+    Trades& trades_;
+};
+
+// Sink that drops every fill, for replays that rebuild book state without re-reporting executions.
+class NullExecutionSink final : public ExecutionSink
+{
+public:
+    void OnTrade(const Trade&) override { }
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+
+#include "Usings.h"
+#include "ObjectPool.h"
+
+// A node linking one order into the expiry list it belongs to.
+struct ExpiryNode
+{
+    OrderId orderId_{ };
+    Timestamp expiry_{ };           // Deadline bucket, or `ExpiryIndex::SessionExpiry` for session-scoped orders.
+    PoolIndex prev_{ NoPoolIndex };
+    PoolIndex next_{ NoPoolIndex };
+};
+
+// Names an order's node in an `ExpiryIndex`.
+using ExpiryHandle = PoolIndex;
+
+// The handle of an order that cannot expire.
+inline constexpr ExpiryHandle NoExpiry = NoPoolIndex;
+
+// Tracks only the orders that can expire, so expiring them costs O(expiring orders) rather than a scan of the book.
+// Session-scoped ("Good-For-Day") orders share one intrusive list; orders with an explicit deadline are
+// chained into one intrusive list per distinct deadline. Orders join on insert and leave in O(1) on cancel or fill.
+// Every list is circular around a sentinel node from the same pool, so linking and unlinking never branch.
+class ExpiryIndex
+{
+public:
+    static constexpr Timestamp SessionExpiry = std::numeric_limits<Timestamp>::min();
+
+    ExpiryIndex(std::size_t capacity, std::pmr::memory_resource* arena = std::pmr::get_default_resource())
+        : nodes_{ capacity, arena }
+        , session_{ NewSentinel(SessionExpiry) }
+        , buckets_{ arena }
+    { }
+
+    ExpiryIndex(const ExpiryIndex&) = delete;
+    void operator=(const ExpiryIndex&) = delete;
+
+    // Adds an order that expires when the current session closes.
+    ExpiryHandle ScheduleSession(OrderId orderId)
+    {
+        return Link(session_, nodes_.Acquire(ExpiryNode{ orderId, SessionExpiry }));
+    }
+
+    // Adds an order that expires at `expiry`.
+    ExpiryHandle Schedule(OrderId orderId, Timestamp expiry)
+    {
+        auto bucket = buckets_.find(expiry);
+        if (bucket == buckets_.end())
+            bucket = buckets_.emplace(expiry, NewSentinel(expiry)).first;
+
+        return Link(bucket->second, nodes_.Acquire(ExpiryNode{ orderId, expiry }));
+    }
+
+    // The deadline an order was scheduled with, or `SessionExpiry` for a session-scoped order.
+    Timestamp Deadline(ExpiryHandle handle) const { return nodes_[handle].expiry_; }
+
+    // Removes an order that was cancelled or filled before expiring.
+    void Remove(ExpiryHandle handle)
+    {
+        const auto node = nodes_[handle];
+        nodes_[node.prev_].next_ = node.next_;
+        nodes_[node.next_].prev_ = node.prev_;
+        nodes_.Release(handle);
+
+        // Drop a deadline bucket once its last order has left
+        if (node.expiry_ != SessionExpiry && node.prev_ == node.next_)
+        {
+            const auto bucket = buckets_.find(node.expiry_);
+            if (bucket != buckets_.end() && nodes_[bucket->second].next_ == bucket->second)
+            {
+                nodes_.Release(bucket->second);
+                buckets_.erase(bucket);
+            }
+        }
+    }
+
+    // Appends the IDs of every session-scoped order.
+    void CollectSession(OrderIds& orderIds) const
+    {
+        Collect(session_, orderIds);
+    }
+
+    // Appends the IDs of every order whose deadline is at or before `now`.
+    void CollectDue(Timestamp now, OrderIds& orderIds) const
+    {
+        for (auto bucket = buckets_.begin(); bucket != buckets_.end() && bucket->first <= now; ++bucket)
+            Collect(bucket->second, orderIds);
+    }
+
+    // The earliest pending deadline, if any order has one.
+    std::optional<Timestamp> NextDeadline() const
+    {
+        if (buckets_.empty())
+            return std::nullopt;
+
+        return buckets_.begin()->first;
+    }
+
+    // Bytes held by the node pool and the deadline buckets; bucket tree nodes are counted at their payload plus the tree's own links.
+    std::size_t MemoryUsage() const
+    {
+        constexpr std::size_t TreeLinks = 4 * sizeof(void*);
+        return nodes_.MemoryUsage() + buckets_.size() * (sizeof(std::pair<const Timestamp, PoolIndex>) + TreeLinks);
+    }
+
+private:
+    // A list head that points at itself, so an empty list needs no special case.
+    PoolIndex NewSentinel(Timestamp expiry)
+    {
+        const auto sentinel = nodes_.Acquire(ExpiryNode{ OrderId{ }, expiry });
+        nodes_[sentinel].prev_ = sentinel;
+        nodes_[sentinel].next_ = sentinel;
+        return sentinel;
+    }
+
+    ExpiryHandle Link(PoolIndex head, ExpiryHandle handle)
+    {
+        const auto tail = nodes_[head].prev_;
+        nodes_[handle].prev_ = tail;
+        nodes_[handle].next_ = head;
+        nodes_[tail].next_ = handle;
+        nodes_[head].prev_ = handle;
+        return handle;
+    }
+
+    void Collect(PoolIndex head, OrderIds& orderIds) const
+    {
+        for (auto node = nodes_[head].next_; node != head; node = nodes_[node].next_)
+            orderIds.push_back(nodes_[node].orderId_);
+    }
+
+    ObjectPool<ExpiryNode> nodes_;
+    PoolIndex session_; // Sentinel of the session-scoped list.
+    std::pmr::map<Timestamp, PoolIndex> buckets_; // Sentinel of each deadline's list, earliest first; nodes come from the book's arena.
+};
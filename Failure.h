@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// How the code base reports failures it cannot handle where they happen: bad files, bad configuration and broken
+// invariants. Expected events such as rejected orders never come through here; see `RejectReason`.
+//
+// By default these throw. Built with -fno-exceptions (`make EXCEPTIONS=0`), `Raise` prints the message and aborts,
+// and handlers written with `ORDERBOOK_TRY` / `ORDERBOOK_CATCH_ALL` compile to a branch that never runs.
+#if defined(__cpp_exceptions)
+#define ORDERBOOK_TRY try
+#define ORDERBOOK_CATCH_ALL catch (...)
+#else
+#define ORDERBOOK_TRY if (true)
+#define ORDERBOOK_CATCH_ALL else
+#endif
+
+// Throws `exception`, or prints it and aborts in a build without exceptions. Kept out of line and cold, so
+// the code around a check stays small enough to inline.
+template<typename Exception>
+[[noreturn, gnu::cold, gnu::noinline]] void Raise(const Exception& exception)
+{
+#if defined(__cpp_exceptions)
+    throw exception;
+#else
+    std::fprintf(stderr, "%s\n", exception.what());
+    std::abort();
+#endif
+}
@@ -0,0 +1,168 @@
+#include "Journal.h"
+#include "Orderbook.h"
+#include "Failure.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Constructor: opens or creates the journal, validating an existing header and dropping a torn tail
+JournalWriter::JournalWriter(const std::string& path, std::size_t groupSize)
+    : groupSize_{ groupSize == 0 ? 1 : groupSize }
+{
+    buffer_.reserve(groupSize_);
+
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+
+    if (!error && size != 0)
+    {
+        JournalHeader header;
+        std::FILE* existing = std::fopen(path.c_str(), "rb");
+        const bool valid = existing != nullptr && std::fread(&header, sizeof(header), 1, existing) == 1
+            && header.magic_ == JournalHeader::CurrentMagic && header.recordSize_ == sizeof(JournalRecord);
+        if (existing != nullptr)
+            std::fclose(existing);
+        if (!valid)
+            Raise(std::runtime_error("Journal (" + path + ") has an unrecognised header"));
+
+        // A crash can leave half a record behind; cut it off so appends stay aligned
+        nextSequence_ = (size - sizeof(JournalHeader)) / sizeof(JournalRecord);
+        std::filesystem::resize_file(path, sizeof(JournalHeader) + nextSequence_ * sizeof(JournalRecord));
+
+        file_ = std::fopen(path.c_str(), "ab");
+    }
+    else
+    {
+        file_ = std::fopen(path.c_str(), "wb");
+        const JournalHeader header;
+        if (file_ != nullptr && std::fwrite(&header, sizeof(header), 1, file_) != 1)
+        {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    if (file_ == nullptr)
+        Raise(std::runtime_error("Journal (" + path + ") could not be opened for writing"));
+
+    // Records go out in whole groups from `buffer_`, so stdio's own buffering would only add a copy
+    std::setvbuf(file_, nullptr, _IONBF, 0);
+}
+
+// Destructor: makes everything appended durable before closing
+JournalWriter::~JournalWriter()
+{
+    ORDERBOOK_TRY
+    {
+        Commit();
+    }
+    ORDERBOOK_CATCH_ALL
+    {
+    }
+
+    std::fclose(file_);
+}
+
+// Function to buffer one command, writing out a full group
+void JournalWriter::Append(const Command& command)
+{
+    buffer_.push_back(JournalRecord::FromCommand(nextSequence_++, command));
+
+    if (buffer_.size() >= groupSize_)
+        Write();
+}
+
+// Function to hand the buffered group to the OS in one write
+void JournalWriter::Write()
+{
+    if (buffer_.empty())
+        return;
+
+    if (std::fwrite(buffer_.data(), sizeof(JournalRecord), buffer_.size(), file_) != buffer_.size())
+        Raise(std::runtime_error("Journal write failed"));
+
+    buffer_.clear();
+    synced_ = false;
+}
+
+// Function to make every appended command durable: the group commit
+void JournalWriter::Commit()
+{
+    Write();
+
+    if (synced_)
+        return;
+
+    std::fflush(file_);
+#if defined(_WIN32)
+    const bool synced = _commit(_fileno(file_)) == 0;
+#elif defined(__linux__)
+    const bool synced = ::fdatasync(::fileno(file_)) == 0;
+#else
+    const bool synced = ::fsync(::fileno(file_)) == 0;
+#endif
+    if (!synced)
+        Raise(std::runtime_error("Journal sync failed"));
+
+    synced_ = true;
+}
+
+// Constructor: maps the journal read-only and finds its valid prefix
+JournalReader::JournalReader(const std::string& path)
+    : file_{ path }
+{
+    const auto bytes = file_.Bytes();
+
+    JournalHeader header;
+    if (bytes.size() < sizeof(header))
+        Raise(std::runtime_error("Journal (" + path + ") is empty"));
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic_ != JournalHeader::CurrentMagic || header.recordSize_ != sizeof(JournalRecord))
+        Raise(std::runtime_error("Journal (" + path + ") has an unrecognised header"));
+
+    const auto records = std::span{ reinterpret_cast<const JournalRecord*>(bytes.data() + sizeof(header)),
+        (bytes.size() - sizeof(header)) / sizeof(JournalRecord) };
+
+    // Stop at the first record out of sequence; anything after it was never committed as a whole
+    std::size_t valid = 0;
+    while (valid < records.size() && records[valid].sequence_ == valid)
+        ++valid;
+
+    records_ = records.first(valid);
+}
+
+// Function to rebuild a book from the journal, feeding it batches straight from the mapping
+std::size_t JournalReader::Replay(Orderbook& orderbook, std::uint64_t fromSequence) const
+{
+    // A clock would move the book to wall time before every batch, expiring orders the original run still had
+    if (orderbook.HasClock())
+        Raise(std::invalid_argument("Journal replay needs a book without a clock, so time comes only from the journal."));
+
+    NullExecutionSink sink;
+    std::array<Command, ReplayBatchSize> batch;
+
+    // Sequence numbers equal positions, so the tail starts at a plain offset
+    const auto tail = records_.subspan(static_cast<std::size_t>(std::min<std::uint64_t>(fromSequence, records_.size())));
+
+    for (std::size_t offset = 0; offset < tail.size(); offset += batch.size())
+    {
+        const auto chunk = tail.subspan(offset, std::min(batch.size(), tail.size() - offset));
+        for (std::size_t i = 0; i < chunk.size(); ++i)
+            batch[i] = chunk[i].ToCommand();
+
+        orderbook.Execute(std::span{ batch.data(), chunk.size() }, sink);
+    }
+
+    return tail.size();
+}
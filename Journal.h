@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Usings.h"
+#include "Command.h"
+#include "Failure.h"
+#include "MappedFile.h"
+
+class Orderbook;
+
+// One journaled command in a fixed-width, padding-free layout, so equal command streams produce equal files.
+struct JournalRecord
+{
+    std::uint64_t sequence_{ };     // Position in the journal, starting at 0; a gap marks the end of valid data.
+    std::uint64_t orderId_{ };
+    std::int64_t timestamp_{ };
+    std::uint32_t instrumentId_{ };
+    std::int32_t price_{ };
+    std::uint32_t quantity_{ };
+    std::uint8_t type_{ };
+    std::uint8_t orderType_{ };
+    std::uint8_t side_{ };
+    std::uint8_t reserved_{ };
+    std::uint32_t displayQuantity_{ }; // Iceberg slice of an add; zero shows everything.
+    std::uint32_t reserved2_{ };
+
+    static JournalRecord FromCommand(std::uint64_t sequence, const Command& command)
+    {
+        return JournalRecord{ sequence, command.orderId_, command.timestamp_, command.instrumentId_, command.price_, command.quantity_,
+            static_cast<std::uint8_t>(command.type_), static_cast<std::uint8_t>(command.orderType_), static_cast<std::uint8_t>(command.side_),
+            std::uint8_t{ }, command.displayQuantity_ };
+    }
+
+    // Throws std::out_of_range for an order ID wider than this build's `OrderId`, rather than truncating it onto another order.
+    Command ToCommand() const
+    {
+        if (orderId_ > std::numeric_limits<OrderId>::max())
+            Raise(std::out_of_range("Journal record's order ID does not fit this build's OrderId."));
+
+        return Command{ static_cast<CommandType>(type_), static_cast<OrderType>(orderType_), static_cast<Side>(side_),
+            instrumentId_, static_cast<OrderId>(orderId_), static_cast<Price>(price_), static_cast<Quantity>(quantity_), timestamp_,
+            static_cast<Quantity>(displayQuantity_) };
+    }
+};
+
+// Icebergs grew the record from 40 bytes; older journals fail the header's record-size check.
+static_assert(sizeof(JournalRecord) == 48 && std::is_trivially_copyable_v<JournalRecord>);
+
+// Leading bytes of every journal file.
+struct JournalHeader
+{
+    static constexpr std::uint64_t CurrentMagic = 0x31304C4E524A424FULL; // "OBJRNL01" read little-endian.
+
+    std::uint64_t magic_{ CurrentMagic };
+    std::uint32_t recordSize_{ sizeof(JournalRecord) };
+    std::uint32_t reserved_{ };
+};
+
+static_assert(sizeof(JournalHeader) == 16 && std::is_trivially_copyable_v<JournalHeader>);
+
+// Append-only writer of inbound commands. Records are buffered and written in groups; `Commit` makes
+// everything appended so far durable with one write and one sync, so a busy writer pays for I/O per batch.
+// Reopening an existing journal drops a torn trailing record and continues its sequence.
+class JournalWriter
+{
+private:
+    std::FILE* file_{ nullptr };
+    std::vector<JournalRecord> buffer_; // Records appended since the last write.
+    std::size_t groupSize_; // Records buffered before they are written without waiting for `Commit`.
+    std::uint64_t nextSequence_{ 0 };
+    bool synced_{ true }; // False while written records may still sit in OS buffers.
+
+    void Write(); // Hands the buffered records to the OS.
+
+public:
+    static constexpr std::size_t DefaultGroupSize = 4096;
+
+    explicit JournalWriter(const std::string& path, std::size_t groupSize = DefaultGroupSize); // Throws std::runtime_error.
+    JournalWriter(const JournalWriter&) = delete;
+    void operator=(const JournalWriter&) = delete;
+    ~JournalWriter(); // Commits whatever is still buffered.
+
+    void Append(const Command& command); // Buffers one command.
+    void Commit(); // Writes and syncs every buffered command.
+    bool Dirty() const { return !buffer_.empty() || !synced_; } // True if `Commit` has anything to do.
+    std::uint64_t NextSequence() const { return nextSequence_; }
+};
+
+// Read-only, memory-mapped view of a journal. Replay streams the mapped records straight into a book,
+// so recovery is bounded by sequential read bandwidth.
+class JournalReader
+{
+private:
+    MappedFile file_; // Mapped file contents.
+    std::span<const JournalRecord> records_; // Valid prefix: whole records with contiguous sequence numbers.
+
+public:
+    static constexpr std::size_t ReplayBatchSize = 256;
+
+    explicit JournalReader(const std::string& path); // Throws std::runtime_error.
+    JournalReader(const JournalReader&) = delete;
+    void operator=(const JournalReader&) = delete;
+
+    std::span<const JournalRecord> Records() const { return records_; }
+
+    // Applies every record from `fromSequence` on to `orderbook` in order with fills suppressed; returns the number applied.
+    // Pass a snapshot's journal sequence to replay only the tail it does not already contain.
+    // The book must have no clock (`OrderbookConfig::clock_` null), so time comes only from the journaled `AdvanceTime`
+    // records and the rebuilt state does not depend on when the replay runs; throws std::invalid_argument otherwise.
+    // Throws std::out_of_range at a record whose order ID does not fit this build's `OrderId`.
+    std::size_t Replay(Orderbook& orderbook, std::uint64_t fromSequence = 0) const;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size latency histogram in the style of HdrHistogram: each power of two is split into equal sub-buckets,
+// so every recorded value keeps about three percent of precision from single nanoseconds up to about 18 minutes;
+// anything longer lands in the top bucket, while `Max` stays exact. Recording is a couple of shifts and an increment
+// with no allocation, and histograms from several threads or runs can be merged before percentiles are read.
+class LatencyHistogram
+{
+private:
+    friend class LatencyRecorder;
+
+    static constexpr unsigned SubBucketBits = 5;
+    static constexpr unsigned ValueBits = 40;
+    static constexpr std::size_t SubBuckets = std::size_t{ 1 } << SubBucketBits;
+    static constexpr std::size_t BucketCount = (ValueBits - SubBucketBits + 1) * SubBuckets;
+    static constexpr std::uint64_t Highest = (std::uint64_t{ 1 } << ValueBits) - 1;
+
+    std::array<std::uint64_t, BucketCount> counts_{ };
+    std::uint64_t count_{ 0 };
+    std::uint64_t sum_{ 0 };
+    std::uint64_t max_{ 0 };
+
+    // Values below `SubBuckets` get a bucket each; above that, a value with bit width `w` lands in
+    // group `w - SubBucketBits - 1`, indexed by its top `SubBucketBits + 1` bits.
+    static std::size_t IndexOf(std::uint64_t value)
+    {
+        value = std::min(value, Highest);
+        if (value < SubBuckets)
+            return static_cast<std::size_t>(value);
+
+        const auto shift = static_cast<unsigned>(std::bit_width(value)) - SubBucketBits - 1;
+        return SubBuckets + shift * SubBuckets + static_cast<std::size_t>((value >> shift) - SubBuckets);
+    }
+
+    // Largest value that maps to the bucket.
+    static std::uint64_t HighestEquivalent(std::size_t index)
+    {
+        if (index < SubBuckets)
+            return index;
+
+        const auto shift = static_cast<unsigned>(index / SubBuckets - 1);
+        const auto lowest = static_cast<std::uint64_t>(SubBuckets + index % SubBuckets) << shift;
+        return lowest + ((std::uint64_t{ 1 } << shift) - 1);
+    }
+
+public:
+    void Record(std::uint64_t value)
+    {
+        ++counts_[IndexOf(value)];
+        ++count_;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    void Merge(const LatencyHistogram& other)
+    {
+        for (std::size_t i = 0; i < BucketCount; ++i)
+            counts_[i] += other.counts_[i];
+
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void Reset() { *this = LatencyHistogram{ }; }
+
+    std::uint64_t Count() const { return count_; }
+    std::uint64_t Max() const { return max_; }
+    double Mean() const { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(count_); }
+
+    // The value at or below which `percentile` percent of recordings fall, to the histogram's precision.
+    std::uint64_t Percentile(double percentile) const
+    {
+        if (count_ == 0)
+            return 0;
+
+        const auto rank = std::clamp(static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count_) + 0.5),
+            std::uint64_t{ 1 }, count_);
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BucketCount; ++i)
+        {
+            seen += counts_[i];
+            if (seen >= rank)
+                return std::min(HighestEquivalent(i), max_);
+        }
+
+        return max_;
+    }
+};
+
+// The single-writer, many-reader form of `LatencyHistogram`. Exactly one thread records at a time (the owner, or
+// whoever holds the owner's lock), so each bucket is bumped with a relaxed load and store instead of a locked
+// read-modify-write, and any other thread can take a `Snapshot` without stopping the writer.
+class LatencyRecorder
+{
+private:
+    using Counter = std::atomic<std::uint64_t>;
+
+    std::array<Counter, LatencyHistogram::BucketCount> counts_{ };
+    Counter sum_{ 0 };
+    Counter max_{ 0 };
+
+    static void Add(Counter& counter, std::uint64_t amount)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+public:
+    void Record(std::uint64_t value)
+    {
+        Add(counts_[LatencyHistogram::IndexOf(value)], 1);
+        Add(sum_, value);
+        if (value > max_.load(std::memory_order_relaxed))
+            max_.store(value, std::memory_order_relaxed);
+    }
+
+    // Buckets are read one by one while the writer carries on, so the sum and max can be a few recordings
+    // ahead of the buckets; the count is taken from the buckets themselves so percentiles stay consistent.
+    LatencyHistogram Snapshot() const
+    {
+        LatencyHistogram histogram;
+        for (std::size_t i = 0; i < LatencyHistogram::BucketCount; ++i)
+            histogram.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+
+        histogram.count_ = 0;
+        for (const auto count : histogram.counts_)
+            histogram.count_ += count;
+        histogram.sum_ = sum_.load(std::memory_order_relaxed);
+        histogram.max_ = max_.load(std::memory_order_relaxed);
+        return histogram;
+    }
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Usings.h"
+#include "Side.h"
+
+// An incremental L2 change: the new aggregate state of one price level after an event.
+// A level that has emptied is reported with zero quantity and count.
+struct LevelUpdate
+{
+    Side side_;
+    Price price_;
+    Quantity quantity_;
+    Quantity count_;
+};
@@ -0,0 +1,89 @@
+#include "MappedFile.h"
+#include "Failure.h"
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Constructor: maps the file read-only and hints that it will be read front to back
+MappedFile::MappedFile(const std::string& path)
+{
+#if defined(_WIN32)
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER size{ };
+    if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &size))
+    {
+        file_ = nullptr;
+        Raise(std::runtime_error("File (" + path + ") could not be opened for reading"));
+    }
+
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    if (size_ != 0)
+    {
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr)
+            data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    struct stat status{ };
+    if (descriptor < 0 || ::fstat(descriptor, &status) != 0)
+    {
+        if (descriptor >= 0)
+            ::close(descriptor);
+        Raise(std::runtime_error("File (" + path + ") could not be opened for reading"));
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ != 0)
+    {
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapped != MAP_FAILED)
+        {
+            data_ = static_cast<const std::byte*>(mapped);
+            ::madvise(mapped, size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    // The mapping keeps the file alive on its own
+    ::close(descriptor);
+#endif
+
+    if (size_ != 0 && data_ == nullptr)
+    {
+        Unmap();
+        Raise(std::runtime_error("File (" + path + ") could not be mapped"));
+    }
+}
+
+// Destructor: unmaps the file
+MappedFile::~MappedFile()
+{
+    Unmap();
+}
+
+// Function to release the mapping and the handles behind it
+void MappedFile::Unmap()
+{
+#if defined(_WIN32)
+    if (data_ != nullptr)
+        UnmapViewOfFile(data_);
+    if (mapping_ != nullptr)
+        CloseHandle(mapping_);
+    if (file_ != nullptr)
+        CloseHandle(file_);
+    file_ = mapping_ = nullptr;
+#else
+    if (data_ != nullptr)
+        ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+// Read-only memory mapping of a whole file, released on destruction.
+class MappedFile
+{
+private:
+    const std::byte* data_{ nullptr };
+    std::size_t size_{ 0 };
+#if defined(_WIN32)
+    void* file_{ nullptr };
+    void* mapping_{ nullptr };
+#endif
+
+    void Unmap(); // Releases the mapping and the handles behind it.
+
+public:
+    explicit MappedFile(const std::string& path); // Throws std::runtime_error; an empty file maps to no bytes.
+    MappedFile(const MappedFile&) = delete;
+    void operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    std::span<const std::byte> Bytes() const { return { data_, size_ }; }
+};
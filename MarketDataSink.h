@@ -0,0 +1,13 @@
+#pragma once
+
+#include "LevelUpdate.h"
+
+// Receives L2 deltas from an order book as each level changes, so consumers can maintain
+// their own replica of the depth without ever snapshotting the book.
+class MarketDataSink
+{
+public:
+    virtual ~MarketDataSink() = default;
+
+    virtual void OnLevelUpdate(const LevelUpdate& update) = 0; // Called after every add, cancel and fill that touches a level.
+};
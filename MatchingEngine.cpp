@@ -0,0 +1,245 @@
+#include "MatchingEngine.h"
+
+#include <utility>
+
+// Constructor: forces the book into single-writer mode, takes over its clock, recovers and starts the engine thread
+MatchingEngine::MatchingEngine(OrderbookConfig config, std::size_t commandCapacity, std::size_t eventCapacity,
+    JournalWriter* journal, const EngineRecovery& recovery, const EngineLoopConfig& loop)
+    : clock_{ std::exchange(config.clock_, nullptr) }
+    , orderbook_{ (config.synchronization_ = Synchronization::SingleWriter, config) }
+    , journal_{ journal }
+    , commands_{ commandCapacity }
+    , events_{ eventCapacity }
+    , waiter_{ loop.wait_ }
+    , onIdle_{ loop.onIdle_ }
+{
+    // Rebuild the book before taking new work; replayed fills were already reported in a previous run
+    std::uint64_t sequence = 0;
+    if (recovery.snapshot_ != nullptr)
+    {
+        orderbook_.RestoreSnapshot(recovery.snapshot_->time_, recovery.snapshot_->orders_);
+        sequence = recovery.snapshot_->journalSequence_;
+    }
+
+    if (recovery.journal_ != nullptr)
+        recovery.journal_->Replay(orderbook_, sequence);
+
+    engineThread_ = std::thread{ [this] { Run(); } };
+}
+
+// Destructor: lets the engine drain what was submitted and waits for it to exit
+MatchingEngine::~MatchingEngine()
+{
+    running_.store(false, std::memory_order_release);
+    waiter_.Notify();
+    engineThread_.join();
+}
+
+// Function to enqueue a command from any producer thread
+bool MatchingEngine::Submit(const Command& command)
+{
+    if (!commands_.TryPush(command))
+        return false;
+
+    waiter_.Notify();
+    return true;
+}
+
+// Function to enqueue a decoded batch, stopping at the first command that does not fit
+std::size_t MatchingEngine::Submit(std::span<const Command> commands)
+{
+    std::size_t submitted = 0;
+    for (const auto& command : commands)
+    {
+        if (!commands_.TryPush(command))
+            break;
+        ++submitted;
+    }
+
+    // One wake-up covers the whole batch
+    if (submitted != 0)
+        waiter_.Notify();
+    return submitted;
+}
+
+// Function to dequeue the next engine output
+bool MatchingEngine::PollEvent(EngineEvent& event)
+{
+    return events_.TryPop(event);
+}
+
+// Engine thread main loop: apply commands until asked to stop and nothing is left
+void MatchingEngine::Run()
+{
+    Command command;
+
+    while (true)
+    {
+        // Expiry is part of the loop, so idle periods still expire orders on time. The clock is read after the pop,
+        // so a command is never applied at a time older than the one its producer saw when submitting it
+        const bool popped = commands_.TryPop(command);
+        AdvanceTime();
+
+        if (snapshotRequested_.load(std::memory_order_acquire))
+            ServeSnapshots();
+
+        if (popped)
+        {
+            waiter_.Reset();
+            Apply(command);
+            continue;
+        }
+
+        // The ring is dry, so this is the end of a burst: commit its journal records together
+        if (journal_ != nullptr && journal_->Dirty())
+            journal_->Commit();
+
+        // Only exit once the ring is empty so accepted commands are never lost
+        if (!running_.load(std::memory_order_acquire))
+        {
+            if (!commands_.TryPop(command))
+                break;
+
+            AdvanceTime();
+            Apply(command);
+            continue;
+        }
+
+        if (onIdle_)
+            onIdle_();
+
+        // Wait as the policy says; a blocking engine rechecks for commands, snapshot requests and shutdown before it sleeps
+        waiter_.Idle([this]
+        {
+            return !commands_.Empty() || snapshotRequested_.load(std::memory_order_acquire) || !running_.load(std::memory_order_acquire);
+        });
+    }
+
+    // Requests that raced with shutdown still get the final book
+    ServeSnapshots();
+}
+
+// Function to ask the engine thread for a copy of its book
+std::future<BookSnapshot> MatchingEngine::RequestSnapshot()
+{
+    std::scoped_lock snapshotLock{ snapshotMutex_ };
+
+    auto future = snapshotRequests_.emplace_back().get_future();
+    snapshotRequested_.store(true, std::memory_order_release);
+    waiter_.Notify();
+    return future;
+}
+
+// Function to read the book's published top of book from any thread
+BestBidOffer MatchingEngine::GetBestBidOffer() const
+{
+    return orderbook_.GetBestBidOffer();
+}
+
+// Function to read the book's published depth from any thread
+DepthSnapshot MatchingEngine::GetPublishedDepth() const
+{
+    return orderbook_.GetPublishedDepth();
+}
+
+// Function to read the book's instrumentation from any thread
+OrderbookStats MatchingEngine::GetStats() const
+{
+    return orderbook_.GetStats();
+}
+
+// Function to capture the book for every waiting request, between two commands
+void MatchingEngine::ServeSnapshots()
+{
+    std::vector<std::promise<BookSnapshot>> requests;
+    {
+        std::scoped_lock snapshotLock{ snapshotMutex_ };
+        requests.swap(snapshotRequests_);
+        snapshotRequested_.store(false, std::memory_order_relaxed);
+    }
+
+    if (requests.empty())
+        return;
+
+    // The snapshot claims every journal record so far, so make sure they are on disk first
+    BookSnapshot snapshot;
+    if (journal_ != nullptr)
+    {
+        journal_->Commit();
+        snapshot.journalSequence_ = journal_->NextSequence();
+    }
+
+    orderbook_.CaptureSnapshot(snapshot);
+
+    for (std::size_t i = 1; i < requests.size(); ++i)
+        requests[i].set_value(snapshot);
+    requests.front().set_value(std::move(snapshot));
+}
+
+// Function to move the book to the clock's time
+void MatchingEngine::AdvanceTime()
+{
+    if (clock_ == nullptr)
+        return;
+
+    // The book always follows the clock, so orders added between expiries are checked against the current time
+    now_ = clock_->Now();
+    if (now_ >= orderbook_.NextExpiry())
+        JournalTime();
+
+    orderbook_.AdvanceTime(now_);
+}
+
+// Function to journal the engine's time if it has moved since the last tick written. Ticks that can expire orders
+// and ticks ahead of a command are enough for replay to rebuild the same book without logging every poll
+void MatchingEngine::JournalTime()
+{
+    if (journal_ == nullptr || now_ <= journaledNow_)
+        return;
+
+    journal_->Append(Command::AdvanceTime(now_));
+    journaledNow_ = now_;
+}
+
+// Function to apply a command to the book and publish its results
+void MatchingEngine::Apply(const Command& command)
+{
+    if (journal_ != nullptr)
+    {
+        JournalTime();
+        journal_->Append(command);
+    }
+
+    // Fills and rejects are published from inside matching through OnTrade and OnReject
+    orderbook_.Execute(std::span{ &command, 1 }, *this);
+
+    Publish(EngineEvent::Ack(command));
+}
+
+// Sink callback: publish each fill straight onto the event ring
+void MatchingEngine::OnTrade(const Trade& trade)
+{
+    Publish(EngineEvent::FromTrade(trade));
+}
+
+// Sink callback: publish each reject as a code, leaving any text to the consumer
+void MatchingEngine::OnReject(OrderId orderId, RejectReason reason)
+{
+    Publish(EngineEvent::FromReject(orderId, reason));
+}
+
+// Function to publish an event, applying backpressure to the engine rather than to producers
+void MatchingEngine::Publish(const EngineEvent& event)
+{
+    while (!events_.TryPush(event))
+    {
+        // Nobody drains events during shutdown, so drop instead of waiting forever
+        if (!running_.load(std::memory_order_acquire))
+            return;
+
+        if (waiter_.GetPolicy().mode_ == WaitMode::BusySpin)
+            CpuRelax();
+        else
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <future>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Orderbook.h"
+#include "Command.h"
+#include "EngineEvent.h"
+#include "MpscRing.h"
+#include "SpscRing.h"
+#include "ExecutionSink.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "WaitPolicy.h"
+
+// What a restarted engine rebuilds its book from: an optional snapshot, then the journal records after it.
+struct EngineRecovery
+{
+    const SnapshotBookView* snapshot_{ nullptr }; // Starting state; null starts from an empty book.
+    const JournalReader* journal_{ nullptr };     // Replayed from the snapshot's journal sequence on.
+};
+
+// How an engine thread spends the time it has no commands for.
+struct EngineLoopConfig
+{
+    WaitPolicy wait_{ };          // Spin, spin then yield, or block; only blocking ever enters the kernel to wait.
+    std::function<void()> onIdle_; // Housekeeping run on the engine thread after every empty poll, before it waits; may be empty.
+};
+
+// Runs an `Orderbook` on a dedicated engine thread that owns it exclusively.
+// Producers hand commands over through a lock-free MPSC ring and never block; the engine
+// applies them in arrival order without taking any lock and publishes trades and acks on an SPSC ring.
+// Orders expire on the engine thread between commands, driven by the configured clock or by `Command::AdvanceTime`.
+// With a journal attached, every command, the clock's time ahead of it and every tick that expires orders are recorded before it is applied and
+// committed in groups whenever the inbound ring runs dry, so replaying the journal rebuilds the same book.
+class MatchingEngine : private ExecutionSink
+{
+private:
+    const SessionClock* clock_; // Read once per loop iteration to expire due orders; may be null.
+    Orderbook orderbook_; // Single-writer book touched only by the engine thread.
+    JournalWriter* journal_; // Optional journal of every command the engine applies, in order.
+    Timestamp now_{ std::numeric_limits<Timestamp>::min() }; // The clock's time at the last loop iteration.
+    Timestamp journaledNow_{ std::numeric_limits<Timestamp>::min() }; // The last time written to the journal as a tick.
+    MpscRing<Command> commands_; // Inbound commands from any number of producers.
+    SpscRing<EngineEvent> events_; // Outbound trades and acks for one consumer.
+    std::atomic<bool> running_{ true }; // Cleared to ask the engine thread to drain and exit.
+    std::atomic<bool> snapshotRequested_{ false }; // Set while `snapshotRequests_` is non-empty.
+    std::mutex snapshotMutex_; // Guards `snapshotRequests_`.
+    std::vector<std::promise<BookSnapshot>> snapshotRequests_; // Snapshots to capture between commands.
+    IdleWaiter waiter_; // How the engine thread waits for commands.
+    std::function<void()> onIdle_; // Optional housekeeping between empty polls.
+    std::thread engineThread_; // The thread that owns `orderbook_`.
+
+    void Run(); // Engine thread main loop.
+    void Apply(const Command& command); // Applies one command to the book.
+    void AdvanceTime(); // Moves the book to the clock, journaling the time if anything may expire.
+    void JournalTime(); // Journals `now_` as a tick unless the journal already has it.
+    void ServeSnapshots(); // Captures the book for every pending snapshot request.
+    void Publish(const EngineEvent& event); // Pushes an event, waiting for the consumer if the ring is full.
+    void OnTrade(const Trade& trade) override; // Publishes each fill as it happens.
+    void OnReject(OrderId orderId, RejectReason reason) override; // Publishes each reject as it happens.
+
+public:
+    static constexpr std::size_t DefaultRingCapacity = 1 << 16;
+
+    explicit MatchingEngine(OrderbookConfig config = { },
+        std::size_t commandCapacity = DefaultRingCapacity,
+        std::size_t eventCapacity = DefaultRingCapacity,
+        JournalWriter* journal = nullptr,
+        const EngineRecovery& recovery = { }, // Recovery finishes before the constructor returns.
+        const EngineLoopConfig& loop = { });
+    MatchingEngine(const MatchingEngine&) = delete;
+    void operator=(const MatchingEngine&) = delete;
+    MatchingEngine(MatchingEngine&&) = delete;
+    void operator=(MatchingEngine&&) = delete;
+    ~MatchingEngine(); // Applies every command already submitted, then stops the engine thread.
+
+    bool Submit(const Command& command); // Any thread: enqueues a command; false if the ring is full.
+    std::size_t Submit(std::span<const Command> commands); // Any thread: enqueues in order until a ring fills; returns how many were taken.
+    bool PollEvent(EngineEvent& event); // One consumer thread: dequeues the next trade, reject or ack, if any.
+
+    // Any thread: the engine copies its book between two commands and keeps matching while the caller writes it out.
+    std::future<BookSnapshot> RequestSnapshot();
+
+    // Any thread: what the engine's book last published, read without a lock and without involving the engine thread.
+    BestBidOffer GetBestBidOffer() const; // Best bid and offer.
+    DepthSnapshot GetPublishedDepth() const; // Top levels and shape, if `OrderbookConfig::publishedDepth_` is set.
+    OrderbookStats GetStats() const; // Counters and latency histograms.
+};
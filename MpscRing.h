@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Constants.h"
+
+// A bounded multi-producer/single-consumer ring buffer (Vyukov's sequenced-cell design).
+// Producers claim a slot with one CAS on the enqueue index and never wait on each other
+// or on the consumer; a full ring is reported to the caller instead.
+template<typename T>
+class MpscRing
+{
+public:
+    explicit MpscRing(std::size_t capacity)
+        : capacity_{ std::bit_ceil(capacity < 2 ? std::size_t{ 2 } : capacity) }
+        , mask_{ capacity_ - 1 }
+        , cells_{ std::make_unique<Cell[]>(capacity_) }
+    {
+        for (std::size_t i = 0; i < capacity_; ++i)
+            cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    void operator=(const MpscRing&) = delete;
+
+    // Producer side, callable from any thread: returns false instead of blocking when the ring is full.
+    bool TryPush(const T& value)
+    {
+        auto position = enqueue_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            auto& cell = cells_[position & mask_];
+            const auto sequence = cell.sequence_.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.value_ = value;
+                    cell.sequence_.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false;
+            else
+                position = enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer side, single thread only: returns false when the ring is empty.
+    bool TryPop(T& value)
+    {
+        auto& cell = cells_[dequeue_ & mask_];
+        const auto sequence = cell.sequence_.load(std::memory_order_acquire);
+
+        if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeue_ + 1) < 0)
+            return false;
+
+        value = cell.value_;
+        cell.sequence_.store(dequeue_ + capacity_, std::memory_order_release);
+        ++dequeue_;
+        return true;
+    }
+
+    // Consumer side, single thread only: true when the next `TryPop` would fail.
+    bool Empty() const
+    {
+        const auto sequence = cells_[dequeue_ & mask_].sequence_.load(std::memory_order_acquire);
+        return static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(dequeue_ + 1) < 0;
+    }
+
+    std::size_t Capacity() const { return capacity_; }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence_{ 0 };
+        T value_{ };
+    };
+
+    std::size_t capacity_;
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(Constants::CacheLineSize) std::atomic<std::size_t> enqueue_{ 0 };
+    alignas(Constants::CacheLineSize) std::size_t dequeue_{ 0 };
+};
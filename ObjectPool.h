@@ -0,0 +1,122 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Failure.h"
+
+// Names an object in an `ObjectPool`.
+using PoolIndex = std::uint32_t;
+
+// The index no object ever has.
+inline constexpr PoolIndex NoPoolIndex = std::numeric_limits<PoolIndex>::max();
+
+// A slab allocator that hands out fixed-size objects from preallocated blocks.
+// Released objects go onto an intrusive free list and are reused before any new slab is allocated,
+// so a pool sized for the working set never touches the global allocator again.
+// Objects are named by 32-bit indices rather than pointers, so structures that link pooled objects together
+// do it in half the space. Slabs hold a power-of-two number of slots, which makes resolving an index
+// a shift, a mask and one load from the slab table. Slabs come from a memory resource, so a book can place them
+// on its own NUMA node and huge pages.
+template<typename T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(std::size_t slabSize, std::pmr::memory_resource* memory = std::pmr::new_delete_resource())
+        : slabBits_{ static_cast<unsigned>(std::countr_zero(std::bit_ceil(slabSize == 0 ? std::size_t{ 1 } : slabSize))) }
+        , memory_{ memory }
+    {
+        Grow(); // Preallocate the first slab up front so the hot path starts warm.
+    }
+
+    // Frees the slabs; objects still in them are not destroyed, which suits the plain records pooled here.
+    ~ObjectPool()
+    {
+        for (auto* slab : slabs_)
+            memory_->deallocate(slab, SlabBytes(), alignof(Slot));
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    void operator=(const ObjectPool&) = delete;
+    ObjectPool(ObjectPool&&) = delete;
+    void operator=(ObjectPool&&) = delete;
+
+    // Constructs an object in a free slot, growing the pool by one slab if none are left.
+    template<typename... Args>
+    PoolIndex Acquire(Args&&... args)
+    {
+        if (free_ == NoPoolIndex)
+            Grow();
+
+        const auto index = free_;
+        auto& slot = SlotAt(index);
+        free_ = slot.next_;
+        std::construct_at(&slot.value_, std::forward<Args>(args)...);
+        return index;
+    }
+
+    // Destroys the object and returns its slot to the free list.
+    void Release(PoolIndex index)
+    {
+        auto& slot = SlotAt(index);
+        std::destroy_at(&slot.value_);
+        slot.next_ = free_;
+        free_ = index;
+    }
+
+    T& operator[](PoolIndex index) { return SlotAt(index).value_; }
+    const T& operator[](PoolIndex index) const { return const_cast<ObjectPool&>(*this).SlotAt(index).value_; }
+
+    // Total number of slots allocated so far, free or in use.
+    std::size_t Capacity() const { return slabs_.size() << slabBits_; }
+
+    // Bytes held by the slabs.
+    std::size_t MemoryUsage() const { return Capacity() * sizeof(Slot); }
+
+private:
+    // Each slot either holds a live object or links to the next free slot.
+    union Slot
+    {
+        Slot() { }
+        ~Slot() { }
+
+        T value_;
+        PoolIndex next_;
+    };
+
+    Slot& SlotAt(PoolIndex index) { return slabs_[index >> slabBits_][index & ((PoolIndex{ 1 } << slabBits_) - 1)]; }
+
+    std::size_t SlabBytes() const { return (std::size_t{ 1 } << slabBits_) * sizeof(Slot); }
+
+    void Grow()
+    {
+        const auto first = Capacity();
+        const auto slabSize = std::size_t{ 1 } << slabBits_;
+        if (first + slabSize > NoPoolIndex)
+            Raise(std::length_error("ObjectPool cannot hold more objects than its index can name."));
+
+        slabs_.reserve(slabs_.size() + 1);
+        auto* slab = static_cast<Slot*>(memory_->allocate(SlabBytes(), alignof(Slot)));
+        std::uninitialized_default_construct_n(slab, slabSize);
+        slabs_.push_back(slab);
+
+        // Thread the new slots onto the free list in address order.
+        for (std::size_t i = slabSize; i-- > 0;)
+        {
+            slab[i].next_ = free_;
+            free_ = static_cast<PoolIndex>(first + i);
+        }
+    }
+
+    unsigned slabBits_;
+    std::pmr::memory_resource* memory_; // Where slabs come from.
+    std::vector<Slot*> slabs_;
+    PoolIndex free_{ NoPoolIndex };
+};
@@ -1,26 +1,29 @@
 #pragma once // Ensures this file is included only once in a single compilation to prevent duplicate declarations.
 
-#include <list>        // Provides the `std::list` container, used for storing a list of orders.
-#include <exception>   // Includes exception handling classes like `std::logic_error`.
+#include <stdexcept>   // Includes exception classes like `std::logic_error`.
 #include <format>      // Allows for formatted string generation, used for error messages.
 
 #include "OrderType.h" // Custom header defining the types of orders, like Market or GoodTillCancel.
 #include "Side.h"      // Custom header defining the side of the order (Buy or Sell).
 #include "Usings.h"    // Header for shorthand type definitions (e.g., `Price`, `Quantity`, `OrderId`).
 #include "Constants.h" // Header for constants used in the application (e.g., an invalid price).
+#include "Failure.h"   // Header for `Raise`, which throws or aborts depending on the build.
 
 // The `Order` class represents an individual order in the order book.
 class Order
 {
 public:
-    // Constructor for orders with all details, such as type, ID, side, price, and quantity.
-    Order(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
+    // Constructor for orders with all details, such as type, ID, side, price, quantity, for GoodTillDate orders, expiry and,
+    // for iceberg orders, the quantity shown at a time.
+    Order(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity, Timestamp expiry = 0, Quantity displayQuantity = 0)
         : orderType_{ orderType }  // Initializes the type of the order (e.g., Market or GoodTillCancel).
         , orderId_{ orderId }      // Initializes the unique identifier for this order.
         , side_{ side }            // Specifies whether this is a Buy or Sell order.
         , price_{ price }          // The price at which the order is placed.
         , initialQuantity_{ quantity }  // The initial quantity of this order.
         , remainingQuantity_{ quantity } // Initially, the remaining quantity is the same as the total quantity.
+        , expiry_{ expiry }        // When a GoodTillDate order stops being valid.
+        , displayQuantity_{ displayQuantity } // How much of a resting iceberg order is shown at a time.
     { }
 
     // Constructor for market orders (type defaults to Market and price is set to invalid).
@@ -43,6 +46,12 @@ public:
     // Getter for the initial quantity of the order when it was created.
     Quantity GetInitialQuantity() const { return initialQuantity_; }
 
+    // Getter for the expiry of a GoodTillDate order.
+    Timestamp GetExpiry() const { return expiry_; }
+
+    // Getter for the display quantity of an iceberg order; zero for an order that rests fully shown.
+    Quantity GetDisplayQuantity() const { return displayQuantity_; }
+
     // Getter for the remaining quantity of the order that has not been fulfilled yet.
     Quantity GetRemainingQuantity() const { return remainingQuantity_; }
 
@@ -55,35 +64,49 @@ public:
     // Reduces the remaining quantity of the order by the given amount to simulate filling the order.
     void Fill(Quantity quantity)
     {
-        // Throws an exception if trying to fill more than the remaining quantity.
+        // Fails if trying to fill more than the remaining quantity.
         if (quantity > GetRemainingQuantity())
-            throw std::logic_error(std::format("Order ({}) cannot be filled for more than its remaining quantity.", GetOrderId()));
+            Fail("cannot be filled for more than its remaining quantity");
 
         remainingQuantity_ -= quantity; // Updates the remaining quantity.
     }
 
+    // Shrinks a resting order in place; the cancelled amount leaves both the initial and the remaining quantity.
+    void Reduce(Quantity quantity)
+    {
+        // Fails if trying to cancel more than is still open.
+        if (quantity > GetRemainingQuantity())
+            Fail("cannot be reduced by more than its remaining quantity");
+
+        initialQuantity_ -= quantity;
+        remainingQuantity_ -= quantity;
+    }
+
     // Converts a Market order to a GoodTillCancel order by assigning it a price.
     void ToGoodTillCancel(Price price) 
     { 
-        // Throws an exception if the order type is not Market.
+        // Fails if the order type is not Market.
         if (GetOrderType() != OrderType::Market)
-            throw std::logic_error(std::format("Order ({}) cannot have its price adjusted, only market orders can.", GetOrderId()));
+            Fail("cannot have its price adjusted, only market orders can");
 
         price_ = price;                 // Sets the new price.
         orderType_ = OrderType::GoodTillCancel; // Changes the type to GoodTillCancel.
     }
 
 private:
+    // Formats and raises a misuse of this order; out of line and cold, so the checks above stay cheap to inline.
+    [[noreturn, gnu::cold, gnu::noinline]] void Fail(const char* what) const
+    {
+        Raise(std::logic_error(std::format("Order ({}) {}.", GetOrderId(), what)));
+    }
+
     OrderType orderType_;         // Stores the type of the order (Market, GoodTillCancel, etc.).
     OrderId orderId_;             // Unique identifier for the order.
     Side side_;                   // Indicates whether the order is Buy or Sell.
     Price price_;                 // The price of the order.
     Quantity initialQuantity_;    // The original quantity of the order when it was created.
     Quantity remainingQuantity_;  // The quantity that is yet to be fulfilled.
+    Timestamp expiry_;            // Deadline for GoodTillDate orders; unused otherwise.
+    Quantity displayQuantity_;    // Slice shown while resting, the rest held in reserve; zero shows everything.
 };
 
-// Alias for a shared pointer to an `Order` object.
-using OrderPointer = std::shared_ptr<Order>;
-
-// Alias for a list of shared pointers to `Order` objects.
-using OrderPointers = std::list<OrderPointer>;
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Usings.h"
+
+// How an `OrderIndex` maps order IDs to slots.
+enum class OrderIndexMode
+{
+    Hashed, // Robin Hood open addressing; works for any ID scheme.
+    Dense,  // Ring indexed by the ID's low bits, backed by the hashed table; for venues with monotonically increasing IDs.
+};
+
+// A flat order-ID table. Entries live inline in one contiguous slot array, so a lookup touches
+// one or two cache lines instead of chasing bucket nodes. Hashed mode uses Robin Hood linear probing
+// with backward-shift deletion, so erasing never leaves tombstones behind.
+// Dense mode keeps a ring indexed by `id mod` its size, with the key stored for checking. Increasing IDs slide through
+// the ring and reuse the slots their predecessors left, however far the IDs run. An ID whose slot is still held by an
+// older order goes to the hashed table instead; the first such collisions double the ring, up to `DenseWindow` times
+// the capacity, so only orders resting across that many later IDs end up hashed.
+template<typename Value>
+class OrderIndex
+{
+public:
+    OrderIndex(std::size_t capacity, OrderIndexMode mode = OrderIndexMode::Hashed,
+        std::pmr::memory_resource* memory = std::pmr::new_delete_resource())
+        : dense_{ memory }
+        , slots_{ memory }
+    {
+        if (mode == OrderIndexMode::Dense)
+        {
+            // The hashed table only takes orders that collide in the ring, so it starts small
+            dense_.resize(std::bit_ceil(std::max<std::size_t>(capacity, 1)));
+            denseLimit_ = dense_.size() * DenseWindow;
+            Rehash(MinimumCapacity);
+        }
+        else
+            Rehash(std::bit_ceil(std::max<std::size_t>(capacity + capacity / 3 + 1, MinimumCapacity)));
+    }
+
+    std::size_t Size() const { return denseSize_ + size_; }
+    std::size_t Capacity() const { return dense_.size() + slots_.size(); }
+
+    // Bytes held by the slot arrays.
+    std::size_t MemoryUsage() const { return (dense_.capacity() + slots_.capacity()) * sizeof(Slot); }
+
+    bool Contains(OrderId orderId) const { return Find(orderId) != nullptr; }
+
+    // Returns the entry for `orderId`, or null if it is not present.
+    Value* Find(OrderId orderId) { return const_cast<Value*>(std::as_const(*this).Find(orderId)); }
+
+    const Value* Find(OrderId orderId) const
+    {
+        if (!dense_.empty())
+        {
+            const auto& slot = dense_[DenseIndex(orderId)];
+            if (slot.distance_ != 0 && slot.key_ == orderId)
+                return &slot.value_;
+
+            // Only an ID that collided in the ring can be in the hashed table
+            if (size_ == 0)
+                return nullptr;
+        }
+
+        const auto index = FindIndex(orderId);
+        return index == NotFound ? nullptr : &slots_[index].value_;
+    }
+
+    // Inserts an entry if the ID is not present yet; returns false for duplicates.
+    bool Insert(OrderId orderId, const Value& value)
+    {
+        if (!dense_.empty())
+        {
+            // The ID may have collided in the ring earlier and be hashed while its slot has since been freed
+            if (size_ != 0 && FindIndex(orderId) != NotFound)
+                return false;
+
+            auto* slot = &dense_[DenseIndex(orderId)];
+            if (slot->distance_ != 0 && slot->key_ != orderId && dense_.size() < denseLimit_)
+            {
+                GrowDense();
+                slot = &dense_[DenseIndex(orderId)];
+            }
+
+            if (slot->distance_ == 0)
+            {
+                *slot = Slot{ orderId, value, 1 };
+                ++denseSize_;
+                return true;
+            }
+
+            if (slot->key_ == orderId)
+                return false;
+        }
+
+        return InsertHashed(orderId, value);
+    }
+
+    // Removes and returns the entry for `orderId` with a single probe sequence.
+    std::optional<Value> Extract(OrderId orderId)
+    {
+        if (!dense_.empty())
+        {
+            auto& slot = dense_[DenseIndex(orderId)];
+            if (slot.distance_ != 0 && slot.key_ == orderId)
+            {
+                slot.distance_ = 0;
+                --denseSize_;
+                return slot.value_;
+            }
+        }
+
+        const auto index = FindIndex(orderId);
+        if (index == NotFound)
+            return std::nullopt;
+
+        std::optional<Value> value{ slots_[index].value_ };
+        EraseAt(index);
+        return value;
+    }
+
+    // Removes the entry for `orderId`; returns whether it was present.
+    bool Erase(OrderId orderId) { return Extract(orderId).has_value(); }
+
+    // Calls `f(orderId, value)` for every entry, in slot order.
+    template<typename F>
+    void ForEach(F&& f) const
+    {
+        for (const auto& slot : dense_)
+            if (slot.distance_ != 0)
+                f(slot.key_, slot.value_);
+        for (const auto& slot : slots_)
+            if (slot.distance_ != 0)
+                f(slot.key_, slot.value_);
+    }
+
+private:
+    static constexpr std::size_t NotFound = static_cast<std::size_t>(-1);
+    static constexpr std::size_t MinimumCapacity = 16;
+    static constexpr std::size_t DenseWindow = 8; // Dense mode's ring grows on collisions up to this many times the capacity.
+
+    struct Slot
+    {
+        OrderId key_{ };
+        Value value_{ };
+        std::uint32_t distance_{ 0 }; // Zero for an empty slot, otherwise probe distance from home plus one.
+    };
+
+    // The ring slot for an ID; increasing IDs take consecutive slots and wrap around
+    std::size_t DenseIndex(OrderId orderId) const
+    {
+        return static_cast<std::size_t>(orderId) & (dense_.size() - 1);
+    }
+
+    // Doubles the ring. Each entry moves to one of the two slots its old one splits into, so none of them collide
+    void GrowDense()
+    {
+        std::pmr::vector<Slot> previous = std::move(dense_);
+        dense_ = std::pmr::vector<Slot>(previous.size() * 2, Slot{ }, previous.get_allocator());
+
+        for (const auto& slot : previous)
+            if (slot.distance_ != 0)
+                dense_[DenseIndex(slot.key_)] = slot;
+    }
+
+    // Inserts into the Robin Hood table, unless the ID is already there
+    bool InsertHashed(OrderId orderId, const Value& value)
+    {
+        if ((size_ + 1) * 4 > slots_.size() * 3)
+            Rehash(slots_.size() * 2);
+
+        // Robin Hood: probe until an empty slot, displacing any entry that sits closer to its home.
+        // Until the first displacement a matching key would have to appear, so duplicates are caught in the same pass.
+        Slot incoming{ orderId, value, 1 };
+        bool displaced = false;
+
+        for (auto index = Home(orderId); ; index = (index + 1) & mask_)
+        {
+            auto& slot = slots_[index];
+
+            if (slot.distance_ == 0)
+            {
+                slot = incoming;
+                ++size_;
+                return true;
+            }
+
+            if (!displaced && slot.key_ == orderId)
+                return false;
+
+            if (slot.distance_ < incoming.distance_)
+            {
+                std::swap(slot, incoming);
+                displaced = true;
+            }
+
+            ++incoming.distance_;
+        }
+    }
+
+    // Fibonacci hashing spreads sequential IDs evenly across the table.
+    std::size_t Home(OrderId orderId) const
+    {
+        return static_cast<std::size_t>((orderId * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    std::size_t FindIndex(OrderId orderId) const
+    {
+        std::uint32_t distance = 1;
+
+        for (auto index = Home(orderId); ; index = (index + 1) & mask_, ++distance)
+        {
+            const auto& slot = slots_[index];
+
+            // An empty slot or one closer to its home than we are ends the search.
+            if (slot.distance_ < distance)
+                return NotFound;
+
+            if (slot.key_ == orderId)
+                return index;
+        }
+    }
+
+    // Backward-shift deletion: pull following displaced entries one slot closer to home.
+    void EraseAt(std::size_t index)
+    {
+        for (auto next = (index + 1) & mask_; slots_[next].distance_ > 1; index = next, next = (next + 1) & mask_)
+        {
+            slots_[index] = slots_[next];
+            --slots_[index].distance_;
+        }
+
+        slots_[index].distance_ = 0;
+        --size_;
+    }
+
+    void Rehash(std::size_t capacity)
+    {
+        std::pmr::vector<Slot> previous = std::move(slots_);
+        slots_ = std::pmr::vector<Slot>(capacity, Slot{ }, previous.get_allocator());
+        mask_ = capacity - 1;
+        shift_ = 64 - std::countr_zero(capacity);
+        size_ = 0;
+
+        for (const auto& slot : previous)
+            if (slot.distance_ != 0)
+                InsertHashed(slot.key_, slot.value_);
+    }
+
+    std::size_t denseLimit_{ 0 }; // Size the ring may grow to; zero in hashed mode.
+    std::pmr::vector<Slot> dense_; // Ring of slots indexed by the ID's low bits in dense mode; empty in hashed mode.
+    std::pmr::vector<Slot> slots_; // Robin Hood table; in dense mode, only IDs whose ring slot was taken. Both allocated from the book's memory resource.
+    std::size_t denseSize_{ 0 };
+    std::size_t size_{ 0 }; // Entries in `slots_`.
+    std::size_t mask_{ 0 };
+    int shift_{ 64 };
+};
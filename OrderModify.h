@@ -26,11 +26,11 @@ public:
     // Getter for the updated quantity of the order.
     Quantity GetQuantity() const { return quantity_; }
 
-    // Converts the modification details into a new `Order` object of the specified type.
-    OrderPointer ToOrderPointer(OrderType type) const
+    // Converts the modification details into a new `Order` of the specified type, keeping any expiry and display quantity.
+    Order ToOrder(OrderType type, Timestamp expiry = 0, Quantity displayQuantity = 0) const
     {
-        // Creates and returns a shared pointer to a new `Order` object using the modification details.
-        return std::make_shared<Order>(type, GetOrderId(), GetSide(), GetPrice(), GetQuantity());
+        // Returns the order by value; the order book copies it into its own pool.
+        return Order{ type, GetOrderId(), GetSide(), GetPrice(), GetQuantity(), expiry, displayQuantity };
     }
 
 private:
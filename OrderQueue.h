@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <vector>
+
+#include "RestingOrder.h"
+
+// How each price level stores its queue of resting orders.
+enum class OrderLayout
+{
+    Intrusive, // Orders are chained through links inside the pooled orders; no per-level allocation.
+    Columnar,  // Each level keeps IDs, remaining quantities and order handles in parallel arrays.
+};
+
+// A FIFO of orders resting at one price level, in one of two layouts. Orders are named by their handles in the
+// book's `RestingOrderPool`, which the queue resolves them through.
+//
+// Intrusive: the prev/next links live inside `RestingOrder`, so pushing and unlinking never allocate
+// and cancelling from the middle of the queue is O(1) given the order itself.
+//
+// Columnar: the hot fields matching reads, the ID and remaining quantity, sit in contiguous arrays next to the
+// handles of the pooled orders, which keep the cold fields. Walking the front of a level is then a sequential
+// read of a few arrays rather than a chain of dependent loads through each order. Each order remembers its slot;
+// cancelling one leaves a hole that is skipped, and the arrays are compacted once holes outnumber live orders.
+// The arrays come from the memory resource the queue was built with, normally the owning book's arena.
+class OrderQueue
+{
+public:
+    // Forward iterator over the queue in time priority.
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = RestingOrder;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const RestingOrder*;
+        using reference = const RestingOrder&;
+
+        Iterator() = default;
+
+        const RestingOrder& operator*() const { return (*queue_->pool_)[queue_->columnar_ ? queue_->orders_[index_] : order_]; }
+        const RestingOrder* operator->() const { return &**this; }
+
+        Iterator& operator++()
+        {
+            if (queue_->columnar_)
+                index_ = queue_->NextLive(index_ + 1);
+            else
+                order_ = (*queue_->pool_)[order_].next_;
+            return *this;
+        }
+
+        Iterator operator++(int) { Iterator previous = *this; ++*this; return previous; }
+        bool operator==(const Iterator& other) const { return order_ == other.order_ && index_ == other.index_; }
+
+    private:
+        friend class OrderQueue;
+
+        Iterator(const OrderQueue* queue, OrderHandle order, std::size_t index)
+            : queue_{ queue }
+            , order_{ order }
+            , index_{ index }
+        { }
+
+        const OrderQueue* queue_{ nullptr };
+        OrderHandle order_{ NoOrder };
+        std::size_t index_{ 0 };
+    };
+
+    OrderQueue() = default;
+
+    OrderQueue(OrderLayout layout, RestingOrderPool& pool, std::pmr::memory_resource* arena = std::pmr::get_default_resource())
+        : pool_{ &pool }
+        , columnar_{ layout == OrderLayout::Columnar }
+        , ids_{ arena }
+        , quantities_{ arena }
+        , orders_{ arena }
+    { }
+
+    bool Empty() const { return columnar_ ? live_ == 0 : head_ == NoOrder; }
+
+    // The order with the highest time priority at this level.
+    OrderHandle Front() const { return columnar_ ? orders_[front_] : head_; }
+
+    // ID and remaining quantity of the front order, read without touching the order in columnar layout.
+    OrderId FrontId() const { return columnar_ ? ids_[front_] : (*pool_)[head_].GetOrderId(); }
+    Quantity FrontQuantity() const { return columnar_ ? quantities_[front_] : (*pool_)[head_].GetRemainingQuantity(); }
+
+    // Fills the front order, keeping the quantity column in step.
+    void FillFront(Quantity quantity)
+    {
+        (*pool_)[Front()].Fill(quantity);
+        if (columnar_)
+            quantities_[front_] -= quantity;
+    }
+
+    // Shrinks an order in place, keeping the quantity column in step.
+    void Reduce(OrderHandle handle, Quantity quantity)
+    {
+        auto& order = (*pool_)[handle];
+        order.Reduce(quantity);
+        if (columnar_)
+            quantities_[order.slot_] -= quantity;
+    }
+
+    // Appends an order at the back of the queue.
+    void PushBack(OrderHandle handle)
+    {
+        auto& order = (*pool_)[handle];
+
+        if (columnar_)
+        {
+            order.slot_ = static_cast<std::uint32_t>(orders_.size());
+            ids_.push_back(order.GetOrderId());
+            quantities_.push_back(order.GetRemainingQuantity());
+            orders_.push_back(handle);
+            ++live_;
+            return;
+        }
+
+        order.prev_ = tail_;
+        order.next_ = NoOrder;
+
+        if (tail_ != NoOrder)
+            (*pool_)[tail_].next_ = handle;
+        else
+            head_ = handle;
+
+        tail_ = handle;
+    }
+
+    // Unlinks an order from anywhere in the queue.
+    void Erase(OrderHandle handle)
+    {
+        auto& order = (*pool_)[handle];
+
+        if (columnar_)
+        {
+            EraseSlot(order.slot_);
+            return;
+        }
+
+        if (order.prev_ != NoOrder)
+            (*pool_)[order.prev_].next_ = order.next_;
+        else
+            head_ = order.next_;
+
+        if (order.next_ != NoOrder)
+            (*pool_)[order.next_].prev_ = order.prev_;
+        else
+            tail_ = order.prev_;
+
+        order.prev_ = NoOrder;
+        order.next_ = NoOrder;
+    }
+
+    // Removes the order at the front of the queue.
+    void PopFront()
+    {
+        if (columnar_)
+            EraseSlot(front_);
+        else
+            Erase(head_);
+    }
+
+    // Shows an iceberg's next slice: the front order takes `shown` as its remaining quantity and goes to the back of
+    // the queue, losing time priority as a new order would, without leaving the level or its pool slot.
+    void RefreshFront(Quantity shown)
+    {
+        const auto handle = Front();
+        PopFront();
+        (*pool_)[handle].remainingQuantity_ = shown;
+        PushBack(handle);
+    }
+
+    Iterator begin() const { return columnar_ ? Iterator{ this, NoOrder, front_ } : Iterator{ this, head_, 0 }; }
+    Iterator end() const { return columnar_ ? Iterator{ this, NoOrder, orders_.size() } : Iterator{ this, NoOrder, 0 }; }
+
+    // Heap bytes held by the columns; an intrusive queue holds none.
+    std::size_t MemoryUsage() const
+    {
+        return ids_.capacity() * sizeof(OrderId) + quantities_.capacity() * sizeof(Quantity) + orders_.capacity() * sizeof(OrderHandle);
+    }
+
+private:
+    static constexpr std::size_t MinimumCompaction = 32;
+
+    // First live slot at or after `from`, or the end of the arrays.
+    std::size_t NextLive(std::size_t from) const
+    {
+        while (from < orders_.size() && orders_[from] == NoOrder)
+            ++from;
+        return from;
+    }
+
+    void EraseSlot(std::size_t slot)
+    {
+        orders_[slot] = NoOrder;
+        quantities_[slot] = 0;
+        --live_;
+
+        if (live_ == 0)
+        {
+            // Keep the capacity: an emptied level is usually refilled
+            ids_.clear();
+            quantities_.clear();
+            orders_.clear();
+            front_ = 0;
+            return;
+        }
+
+        if (slot == front_)
+            front_ = NextLive(front_ + 1);
+
+        if (orders_.size() - live_ >= std::max(live_, MinimumCompaction))
+            Compact();
+    }
+
+    // Moves the live slots to the start of the arrays in time order and tells each order where it now is.
+    void Compact()
+    {
+        std::size_t to = 0;
+        for (std::size_t from = front_; from < orders_.size(); ++from)
+        {
+            if (orders_[from] == NoOrder)
+                continue;
+
+            ids_[to] = ids_[from];
+            quantities_[to] = quantities_[from];
+            orders_[to] = orders_[from];
+            (*pool_)[orders_[to]].slot_ = static_cast<std::uint32_t>(to);
+            ++to;
+        }
+
+        ids_.resize(to);
+        quantities_.resize(to);
+        orders_.resize(to);
+        front_ = 0;
+    }
+
+    RestingOrderPool* pool_{ nullptr }; // The book's order storage.
+    bool columnar_{ false };
+
+    // Intrusive layout
+    OrderHandle head_{ NoOrder };
+    OrderHandle tail_{ NoOrder };
+
+    // Columnar layout: slot `i` of every array describes the same order; `NoOrder` marks a hole
+    std::pmr::vector<OrderId> ids_;
+    std::pmr::vector<Quantity> quantities_;
+    std::pmr::vector<OrderHandle> orders_;
+    std::size_t front_{ 0 }; // First live slot.
+    std::size_t live_{ 0 };  // Live slots.
+};
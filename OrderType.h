@@ -7,4 +7,5 @@ enum class OrderType
 	FillOrKill,
 	GoodForDay,
 	Market,
+	GoodTillDate,
 };
\ No newline at end of file
@@ -0,0 +1,1063 @@
+#include "Orderbook.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+// Function to catch the book up with its clock, so due orders expire before the call is applied
+void Orderbook::SyncClock()
+{
+    if (clock_ != nullptr)
+        AdvanceTimeInternal(clock_->Now());
+}
+
+// Function to move the book to `now`, expiring whatever has become due
+void Orderbook::AdvanceTime(Timestamp now)
+{
+    auto ordersLock = LockOrders();
+
+    AdvanceTimeInternal(now);
+}
+
+// Function to report when the book next has something to expire
+Timestamp Orderbook::NextExpiry() const
+{
+    auto ordersLock = LockOrders();
+
+    return nextExpiry_;
+}
+
+// Function to move the book to `now` with the lock already held
+void Orderbook::AdvanceTimeInternal(Timestamp now)
+{
+    // Time never runs backwards, and most calls arrive with nothing due
+    now_ = std::max(now_, now);
+    if (now_ < nextExpiry_)
+        return;
+
+    if (nextClose_ == std::numeric_limits<Timestamp>::min())
+    {
+        // The first time seen opens the session rather than closing one
+        nextClose_ = calendar_ != nullptr ? calendar_->NextClose(now_) : SessionCalendar::Never;
+    }
+    else if (now_ >= nextClose_)
+    {
+        CancelGoodForDayOrdersInternal();
+        nextClose_ = calendar_->NextClose(now_);
+    }
+
+    ExpireOrdersInternal(now_);
+
+    nextExpiry_ = std::min(nextClose_, expiries_.NextDeadline().value_or(SessionCalendar::Never));
+}
+
+// Function to cancel every resting "Good For Day" order
+void Orderbook::CancelGoodForDayOrders()
+{
+    auto ordersLock = LockOrders();
+
+    CancelGoodForDayOrdersInternal();
+}
+
+// Function to sweep "Good For Day" orders with the lock already held
+void Orderbook::CancelGoodForDayOrdersInternal()
+{
+    OrderbookInstrumentation::Scope timer{ stats_, OrderbookTimer::SessionSweep };
+
+    // Collect the IDs of orders to be canceled into the book's scratch list, which keeps its capacity between sweeps
+    expiring_.clear();
+
+    // Only the session's own expiry list is walked, never the whole book
+    expiries_.CollectSession(expiring_);
+
+    // Cancel the identified orders
+    for (const auto& orderId : expiring_)
+        CancelOrderInternal(orderId);
+}
+
+// Function to cancel every order whose deadline is at or before `now`
+void Orderbook::ExpireOrders(Timestamp now)
+{
+    auto ordersLock = LockOrders();
+
+    ExpireOrdersInternal(now);
+}
+
+// Function to expire due "Good Till Date" orders with the lock already held
+void Orderbook::ExpireOrdersInternal(Timestamp now)
+{
+    expiring_.clear();
+    expiries_.CollectDue(now, expiring_);
+
+    for (const auto& orderId : expiring_)
+        CancelOrderInternal(orderId);
+}
+
+// Function to take the orders mutex, or nothing at all for a single-writer book
+std::unique_lock<std::mutex> Orderbook::LockOrders() const
+{
+    if (synchronization_ == Synchronization::SingleWriter)
+        return { };
+
+    // An uncontended lock costs no clock reads; a wait is recorded once the lock is held, so only one thread writes the stats
+    std::unique_lock ordersLock{ ordersMutex_, std::try_to_lock };
+    if (ordersLock.owns_lock())
+    {
+        stats_.RecordUncontended(OrderbookTimer::LockWait);
+        return ordersLock;
+    }
+
+    {
+        OrderbookInstrumentation::Scope wait{ stats_, OrderbookTimer::LockWait };
+        ordersLock.lock();
+    }
+
+    return ordersLock;
+}
+
+// Function to cancel multiple orders under one lock
+void Orderbook::CancelOrders(std::span<const OrderId> orderIds)
+{
+    // Lock orders to safely modify the order list
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    // Iterate through the list of order IDs and cancel each order
+    for (const auto& orderId : orderIds)
+        CancelOrderInternal(orderId);
+}
+
+// Function to cancel a specific order internally
+bool Orderbook::CancelOrderInternal(OrderId orderId, bool publish)
+{
+    OrderbookInstrumentation::Scope timer{ stats_, OrderbookTimer::CancelOrder };
+
+    // Look up and remove the order in a single probe; unknown IDs are left to the caller to report
+    const auto entry = orders_.Extract(orderId);
+    if (!entry)
+        return false;
+
+    stats_.Count(OrderbookCounter::OrdersRemoved);
+
+    const auto handle = entry->order_;
+    const auto& order = orderPool_[handle];
+
+    // Leave the expiry index, if the order was in it, and drop an iceberg's hidden part
+    if (entry->expiry_ != NoExpiry)
+        expiries_.Remove(entry->expiry_);
+    if (entry->reserve_ != NoReserve)
+        reserves_.Release(entry->reserve_);
+
+    // Determine if the order was a "sell" or "buy" and update the respective side
+    if (order.GetSide() == Side::Sell)
+    {
+        auto price = order.GetPrice(); // Get the price of the order
+        auto& level = asks_.At(price); // Find the sell level at that price
+        level.orders_.Erase(handle); // Unlink the specific order
+        OnOrderCancelled(level, order); // Notify that the order was canceled
+        if (level.orders_.Empty()) // If no orders are left, remove the price level
+            asks_.Erase(price);
+    }
+    else
+    {
+        auto price = order.GetPrice();
+        auto& level = bids_.At(price); // Find the buy level at that price
+        level.orders_.Erase(handle);
+        OnOrderCancelled(level, order);
+        if (level.orders_.Empty())
+            bids_.Erase(price);
+    }
+
+    // Hand the order's slot back to the pool
+    orderPool_.Release(handle);
+
+    if (publish)
+        UpdateTopOfBook();
+    return true;
+}
+
+// Function to count a reject and hand its code to the sink; nothing is formatted here
+void Orderbook::Reject(ExecutionSink& sink, OrderId orderId, RejectReason reason)
+{
+    stats_.Count(OrderbookCounter::OrdersRejected);
+    sink.OnReject(orderId, reason);
+}
+
+// Function to refresh the cached top of book and republish it if it changed
+void Orderbook::UpdateTopOfBook()
+{
+    // Every mutation ends here, so this is also where the book's shape is published to the stats
+    stats_.RecordShape(bids_.Size(), asks_.Size(), orders_.Size(), orders_.Capacity());
+
+    BestBidOffer topOfBook;
+
+    if (!bids_.Empty())
+        topOfBook.bid_ = LevelInfo{ bids_.BestPrice(), bids_.Best().quantity_ };
+
+    if (!asks_.Empty())
+        topOfBook.ask_ = LevelInfo{ asks_.BestPrice(), asks_.Best().quantity_ };
+
+    // Readers only see a new sequence when something they care about moved
+    if (topOfBook != topOfBook_)
+    {
+        topOfBook_ = topOfBook;
+        publishedTopOfBook_.Store(topOfBook);
+    }
+
+    UpdateDepthOfBook();
+}
+
+// Function to refresh the depth snapshot and republish it if it changed
+void Orderbook::UpdateDepthOfBook()
+{
+    if (publishedDepth_ == 0)
+        return;
+
+    DepthSnapshot depth;
+    depth.restingOrders_ = orders_.Size();
+    depth.bidLevels_ = bids_.Size();
+    depth.askLevels_ = asks_.Size();
+    depth.bidQuantity_ = bids_.TotalQuantity();
+    depth.askQuantity_ = asks_.TotalQuantity();
+
+    // Only the top levels are walked, however deep the book is
+    auto CopyLevels = [this](const auto& side, std::array<LevelInfo, DepthSnapshot::MaxLevels>& levels)
+    {
+        std::size_t count = 0;
+        for (const auto& [price, level] : side)
+        {
+            if (count == publishedDepth_)
+                break;
+
+            levels[count++] = LevelInfo{ price, level.quantity_ };
+        }
+
+        return count;
+    };
+
+    depth.bidDepth_ = CopyLevels(bids_, depth.bids_);
+    depth.askDepth_ = CopyLevels(asks_, depth.asks_);
+
+    auto SameLevels = [](const auto& left, const auto& right, std::size_t count)
+    {
+        return std::equal(left.begin(), left.begin() + count, right.begin(),
+            [](const LevelInfo& a, const LevelInfo& b) { return a.price_ == b.price_ && a.quantity_ == b.quantity_; });
+    };
+
+    // As with the top of book, readers only see a new version when something changed
+    if (depth.restingOrders_ == depthOfBook_.restingOrders_ && depth.bidLevels_ == depthOfBook_.bidLevels_
+        && depth.askLevels_ == depthOfBook_.askLevels_ && depth.bidQuantity_ == depthOfBook_.bidQuantity_
+        && depth.askQuantity_ == depthOfBook_.askQuantity_ && depth.bidDepth_ == depthOfBook_.bidDepth_
+        && depth.askDepth_ == depthOfBook_.askDepth_ && SameLevels(depth.bids_, depthOfBook_.bids_, depth.bidDepth_)
+        && SameLevels(depth.asks_, depthOfBook_.asks_, depth.askDepth_))
+        return;
+
+    depth.version_ = depthOfBook_.version_ + 1;
+    depthOfBook_ = depth;
+    publishedDepthOfBook_.Store(depth);
+}
+
+// Event handler for when an order is canceled
+void Orderbook::OnOrderCancelled(PriceLevel& level, const RestingOrder& order)
+{
+    // Update the aggregates of the price level where the order was
+    UpdateLevelData(level, order.GetSide(), order.GetPrice(), order.GetRemainingQuantity(), LevelAction::Remove);
+}
+
+// Event handler for when a new order is added
+void Orderbook::OnOrderAdded(PriceLevel& level, const RestingOrder& order)
+{
+    // Update the aggregates of the price level where the new order was added
+    UpdateLevelData(level, order.GetSide(), order.GetPrice(), order.GetRemainingQuantity(), LevelAction::Add);
+}
+
+// Event handler for when an order is matched
+void Orderbook::OnOrderMatched(PriceLevel& level, Side side, Price price, Quantity quantity, bool filled)
+{
+    // Update the aggregates based on whether the order was fully matched or partially filled
+    UpdateLevelData(level, side, price, quantity, filled ? LevelAction::Remove : LevelAction::Match);
+}
+
+// Event handler for when an iceberg's shown slice fills and its next slice is shown
+void Orderbook::OnOrderRefreshed(PriceLevel& level, Side side, Price price, Quantity filled, Quantity shown)
+{
+    // The order stays on the level, so its count holds; the fill and the new slice go out as one delta
+    level.quantity_ = level.quantity_ - filled + shown;
+    if (side == Side::Buy)
+    {
+        bids_.RemoveQuantity(filled);
+        bids_.AddQuantity(shown);
+    }
+    else
+    {
+        asks_.RemoveQuantity(filled);
+        asks_.AddQuantity(shown);
+    }
+
+    if (marketDataSink_ != nullptr)
+        marketDataSink_->OnLevelUpdate(LevelUpdate{ side, price, level.quantity_, level.count_ });
+}
+
+// Event handler for when an order is reduced in place
+void Orderbook::OnOrderReduced(PriceLevel& level, const RestingOrder& order, Quantity quantity)
+{
+    // The order keeps its place, so only the level's quantity shrinks
+    UpdateLevelData(level, order.GetSide(), order.GetPrice(), quantity, LevelAction::Reduce);
+}
+
+// Function to update the aggregates stored alongside a price level's queue
+void Orderbook::UpdateLevelData(PriceLevel& level, Side side, Price price, Quantity quantity, LevelAction action)
+{
+    // Update the order count based on the action (Add or Remove)
+    level.count_ += action == LevelAction::Remove ? -1 : action == LevelAction::Add ? 1 : 0;
+
+    // Update the quantity at the price level based on the action
+    if (action != LevelAction::Add)
+    {
+        level.quantity_ -= quantity;
+        if (side == Side::Buy)
+            bids_.RemoveQuantity(quantity);
+        else
+            asks_.RemoveQuantity(quantity);
+    }
+    else
+    {
+        level.quantity_ += quantity;
+        if (side == Side::Buy)
+            bids_.AddQuantity(quantity);
+        else
+            asks_.AddQuantity(quantity);
+    }
+
+    // Publish the level's new aggregate state as an L2 delta
+    if (marketDataSink_ != nullptr)
+        marketDataSink_->OnLevelUpdate(LevelUpdate{ side, price, level.quantity_, level.count_ });
+}
+
+// Function to check whether an order on the given side would cross the spread at the given price
+bool Orderbook::CanMatch(Side side, Price price) const
+{
+    if (side == Side::Buy)
+    {
+        // A buy can only match if there is an ask at or below its price
+        if (asks_.Empty())
+            return false;
+
+        return price >= asks_.BestPrice();
+    }
+    else
+    {
+        // A sell can only match if there is a bid at or above its price
+        if (bids_.Empty())
+            return false;
+
+        return price <= bids_.BestPrice();
+    }
+}
+
+// Function to check whether enough opposite liquidity exists up to the limit price
+bool Orderbook::CanFullyFill(Side side, Price price, Quantity quantity) const
+{
+    if (!CanMatch(side, price))
+        return false;
+
+    // Only shown quantity counts, so an order that only an iceberg's reserve could complete is turned away.
+    // The side totals settle the common cases without touching a level: not enough liquidity anywhere,
+    // or a limit at or through the worst level so everything on the side is reachable
+    auto HasLiquidity = [quantity](const auto& levels, auto withinLimit) mutable
+    {
+        if (levels.TotalQuantity() < quantity)
+            return false;
+
+        if (withinLimit(levels.WorstPrice()))
+            return true;
+
+        // Otherwise walk from the best level, summing level aggregates until the limit price
+        for (const auto& [levelPrice, level] : levels)
+        {
+            if (!withinLimit(levelPrice))
+                return false;
+
+            if (quantity <= level.quantity_)
+                return true;
+
+            quantity -= level.quantity_;
+        }
+
+        return false;
+    };
+
+    if (side == Side::Buy)
+        return HasLiquidity(asks_, [price](Price levelPrice) { return levelPrice <= price; });
+
+    return HasLiquidity(bids_, [price](Price levelPrice) { return levelPrice >= price; });
+}
+
+// Function to forget an order that has been filled and already unlinked from its level
+void Orderbook::RemoveFilledOrder(OrderId orderId, OrderHandle order)
+{
+    const auto entry = orders_.Extract(orderId);
+    if (entry && entry->expiry_ != NoExpiry)
+        expiries_.Remove(entry->expiry_);
+    if (entry && entry->reserve_ != NoReserve)
+        reserves_.Release(entry->reserve_);
+
+    orderPool_.Release(order);
+}
+
+// Function to take a matched quantity off the front order of a level, removing the order once it is filled
+void Orderbook::MatchFront(PriceLevel& level, Side side, Price price, Quantity quantity)
+{
+    if (quantity != level.orders_.FrontQuantity())
+    {
+        OnOrderMatched(level, side, price, quantity, false);
+        level.orders_.FillFront(quantity);
+        return;
+    }
+
+    const auto orderId = level.orders_.FrontId();
+    const auto order = level.orders_.Front();
+
+    // An iceberg whose slice filled shows the next one from the back of the same level: no new order, no index
+    // churn, and the level only sees the shown quantity change
+    if (orderPool_[order].IsIceberg())
+    {
+        auto& reserve = reserves_[orders_.Find(orderId)->reserve_];
+        if (reserve.hiddenQuantity_ != 0)
+        {
+            const auto shown = std::min(reserve.displayQuantity_, reserve.hiddenQuantity_);
+            reserve.hiddenQuantity_ -= shown;
+            OnOrderRefreshed(level, side, price, quantity, shown);
+            level.orders_.RefreshFront(shown);
+            return;
+        }
+    }
+
+    // Fully filled orders leave the book and free their pool slot
+    OnOrderMatched(level, side, price, quantity, true);
+    level.orders_.PopFront();
+    RemoveFilledOrder(orderId, order);
+}
+
+// Function to match an incoming order against the resting side it crosses, best level first and in time priority
+// within each level, reporting each fill to `sink`. The incoming order is never queued, so it is only ever at the
+// front of the match and a fill that finishes it costs nothing on its own side of the book
+template <Side RestingSide>
+Quantity Orderbook::Sweep(PriceLevels<RestingSide>& levels, const Order& order, ExecutionSink& sink)
+{
+    OrderbookInstrumentation::Scope timer{ stats_, OrderbookTimer::MatchOrders };
+
+    const auto limit = order.GetPrice();
+    auto remaining = order.GetRemainingQuantity();
+    std::uint64_t fills = 0;
+
+    while (remaining != 0 && !levels.Empty())
+    {
+        const auto levelPrice = levels.BestPrice();
+
+        // Stop once the best resting level is beyond the incoming order's limit
+        if (RestingSide == Side::Sell ? levelPrice > limit : levelPrice < limit)
+            break;
+
+        auto& level = levels.Best();
+        while (remaining != 0 && !level.orders_.Empty())
+        {
+            // Everything about the resting order comes from the queue, and in columnar levels from their arrays,
+            // so one that fills completely is never read, only handed back to the pool
+            const auto quantity = std::min(remaining, level.orders_.FrontQuantity());
+            const TradeInfo incoming{ order.GetOrderId(), limit, quantity };
+            const TradeInfo resting{ level.orders_.FrontId(), levelPrice, quantity };
+
+            if constexpr (RestingSide == Side::Sell)
+                sink.OnTrade(Trade{ incoming, resting });
+            else
+                sink.OnTrade(Trade{ resting, incoming });
+            ++fills;
+
+            MatchFront(level, RestingSide, levelPrice, quantity);
+            remaining -= quantity;
+        }
+
+        // Remove the price level if the sweep emptied it
+        if (level.orders_.Empty())
+            levels.Erase(levelPrice);
+    }
+
+    if (fills != 0)
+    {
+        stats_.Count(OrderbookCounter::Trades, fills);
+        stats_.RecordMatchDepth(fills);
+    }
+
+    return order.GetRemainingQuantity() - remaining;
+}
+
+namespace
+{
+    // The resource behind a book's long-lived storage
+    std::pmr::memory_resource* MemoryOf(const OrderbookConfig& config)
+    {
+        return config.memory_ != nullptr ? config.memory_ : std::pmr::new_delete_resource();
+    }
+}
+
+// Constructor: sets up level storage, sizes the order pools and opens the book's arena
+Orderbook::Orderbook(const OrderbookConfig& config)
+    : orderPool_{ config.orderCapacity_, MemoryOf(config) }
+    , reserves_{ config.orderCapacity_ / 16, MemoryOf(config) } // Icebergs are a small share of resting orders
+    , arena_{ MemoryOf(config) }
+    , bids_{ config, orderPool_, &arena_ }
+    , asks_{ config, orderPool_, &arena_ }
+    , orders_{ config.orderCapacity_, config.orderIndexMode_, MemoryOf(config) }
+    , expiries_{ config.orderCapacity_, &arena_ }
+    , synchronization_{ config.synchronization_ }
+    , marketDataSink_{ config.marketDataSink_ }
+    , clock_{ config.clock_ }
+    , calendar_{ config.calendar_ }
+    , publishedDepth_{ std::min(config.publishedDepth_, DepthSnapshot::MaxLevels) }
+    , stats_{ config.latencyHistograms_, MemoryOf(config) }
+{
+    // Open the session now, so a close that passes before the first call is still seen
+    SyncClock();
+}
+
+// Function to add a new order and run matching
+Trades Orderbook::AddOrder(const Order& order)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    Trades trades;
+    TradeCollector sink{ trades };
+    AddOrderInternal(order, sink);
+    return trades;
+}
+
+// Function to add a new order and report its fills straight to `sink`
+void Orderbook::AddOrder(const Order& order, ExecutionSink& sink)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    AddOrderInternal(order, sink);
+}
+
+// Function to add a new order of a type known at compile time and run matching
+template <OrderType Type>
+Trades Orderbook::AddOrder(const Order& order)
+{
+    Trades trades;
+    TradeCollector sink{ trades };
+    AddOrder<Type>(order, sink);
+    return trades;
+}
+
+// Function to add a new order of a type known at compile time and report its fills straight to `sink`
+template <OrderType Type>
+void Orderbook::AddOrder(const Order& order, ExecutionSink& sink)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    if (order.GetOrderType() != Type)
+        return Reject(sink, order.GetOrderId(), RejectReason::WrongOrderType);
+
+    AddOrderInternal<Type>(order, sink);
+}
+
+// Function to add a batch of orders under one lock, appending all fills to `trades`
+void Orderbook::AddOrders(std::span<const Order> orders, Trades& trades)
+{
+    TradeCollector sink{ trades };
+    AddOrders(orders, sink);
+}
+
+// Function to add a batch of orders under one lock, reporting all fills to `sink`
+void Orderbook::AddOrders(std::span<const Order> orders, ExecutionSink& sink)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    for (const auto& order : orders)
+        AddOrderInternal(order, sink);
+}
+
+// Function to send a single order down the path for its type, with the lock already held
+void Orderbook::AddOrderInternal(const Order& order, ExecutionSink& sink)
+{
+    switch (order.GetOrderType())
+    {
+    case OrderType::GoodTillCancel:
+        AddOrderInternal<OrderType::GoodTillCancel>(order, sink);
+        break;
+    case OrderType::FillAndKill:
+        AddOrderInternal<OrderType::FillAndKill>(order, sink);
+        break;
+    case OrderType::FillOrKill:
+        AddOrderInternal<OrderType::FillOrKill>(order, sink);
+        break;
+    case OrderType::GoodForDay:
+        AddOrderInternal<OrderType::GoodForDay>(order, sink);
+        break;
+    case OrderType::Market:
+        AddOrderInternal<OrderType::Market>(order, sink);
+        break;
+    case OrderType::GoodTillDate:
+        AddOrderInternal<OrderType::GoodTillDate>(order, sink);
+        break;
+    }
+}
+
+// Function to add a single order of a type known at compile time, with the lock already held
+template <OrderType Type>
+void Orderbook::AddOrderInternal(const Order& request, ExecutionSink& sink)
+{
+    OrderbookInstrumentation::Scope timer{ stats_, OrderbookTimer::AddOrder };
+    stats_.Count(OrderbookCounter::OrdersAdded);
+
+    // "Fill-And-Kill" and "Fill-Or-Kill" orders trade on arrival or not at all, so they never rest
+    constexpr bool Rests = Type != OrderType::FillAndKill && Type != OrderType::FillOrKill;
+
+    // Work on a local copy so rejected orders never touch the pool
+    Order candidate = request;
+
+    // An order for nothing would neither trade nor rest, so it is turned away rather than silently dropped
+    if (candidate.GetInitialQuantity() == 0)
+        return Reject(sink, candidate.GetOrderId(), RejectReason::InvalidQuantity);
+
+    // A market order is priced at the worst opposite level so it can sweep the whole side
+    if constexpr (Type == OrderType::Market)
+    {
+        if (candidate.GetSide() == Side::Buy && !asks_.Empty())
+            candidate.ToGoodTillCancel(asks_.WorstPrice());
+        else if (candidate.GetSide() == Side::Sell && !bids_.Empty())
+            candidate.ToGoodTillCancel(bids_.WorstPrice());
+        else
+            return Reject(sink, candidate.GetOrderId(), RejectReason::NoLiquidity);
+    }
+
+    // Reject prices the level storage cannot hold (outside a ladder's band or off tick)
+    if (candidate.GetSide() == Side::Buy ? !bids_.Accepts(candidate.GetPrice()) : !asks_.Accepts(candidate.GetPrice()))
+        return Reject(sink, candidate.GetOrderId(), RejectReason::PriceOutOfBand);
+
+    // FillOrKill orders need enough liquidity to fill completely; FillAndKill and market orders only need to cross,
+    // and a market order always does since it is priced through the whole opposite side
+    bool crosses = true;
+    if constexpr (Type == OrderType::FillOrKill)
+    {
+        if (!CanFullyFill(candidate.GetSide(), candidate.GetPrice(), candidate.GetInitialQuantity()))
+            return Reject(sink, candidate.GetOrderId(), RejectReason::CannotFullyFill);
+    }
+    else if constexpr (Type != OrderType::Market)
+    {
+        crosses = CanMatch(candidate.GetSide(), candidate.GetPrice());
+        if (!Rests && !crosses)
+            return Reject(sink, candidate.GetOrderId(), RejectReason::NoLiquidity);
+    }
+
+    // An order that is already past its deadline never rests
+    if constexpr (Type == OrderType::GoodTillDate)
+    {
+        if (candidate.GetExpiry() <= now_)
+            return Reject(sink, candidate.GetOrderId(), RejectReason::Expired);
+    }
+
+    if (crosses)
+    {
+        // A duplicate ID is rejected before it can trade, just as it would be at the resting insert
+        if (orders_.Find(candidate.GetOrderId()) != nullptr)
+            return Reject(sink, candidate.GetOrderId(), RejectReason::DuplicateOrderId);
+
+        const auto filled = candidate.GetSide() == Side::Buy ? Sweep(asks_, candidate, sink) : Sweep(bids_, candidate, sink);
+        if constexpr (Rests)
+            candidate.Fill(filled);
+    }
+
+    // Whatever is left rests, an iceberg showing one slice of it; the sweep stopped short of the limit, so it no longer crosses
+    if constexpr (Rests)
+    {
+        const auto display = candidate.GetDisplayQuantity();
+        const auto shown = display != 0 ? std::min(display, candidate.GetRemainingQuantity()) : candidate.GetRemainingQuantity();
+        if (!candidate.IsFilled() && !RestOrder(candidate, shown))
+            return Reject(sink, candidate.GetOrderId(), RejectReason::DuplicateOrderId);
+    }
+
+    UpdateTopOfBook();
+}
+
+// Function to place an order in the pool, the ID index, the expiry index and its level, without matching
+bool Orderbook::RestOrder(const Order& candidate, Quantity shown)
+{
+    // Orders that can expire join the expiry index up front
+    ExpiryHandle expiry = NoExpiry;
+    if (candidate.GetOrderType() == OrderType::GoodForDay)
+        expiry = expiries_.ScheduleSession(candidate.GetOrderId());
+    else if (candidate.GetOrderType() == OrderType::GoodTillDate)
+    {
+        expiry = expiries_.Schedule(candidate.GetOrderId(), candidate.GetExpiry());
+        nextExpiry_ = std::min(nextExpiry_, candidate.GetExpiry());
+    }
+
+    // Whatever is not shown waits in an iceberg reserve
+    ReserveHandle reserve = NoReserve;
+    if (shown < candidate.GetRemainingQuantity())
+        reserve = reserves_.Acquire(OrderReserve{ candidate.GetDisplayQuantity(), candidate.GetRemainingQuantity() - shown });
+
+    // Copy the order into the pool as its compact resting record and register its ID; the insert also rejects duplicate IDs
+    const auto handle = orderPool_.Acquire(candidate, shown);
+    if (!orders_.Insert(candidate.GetOrderId(), OrderEntry{ handle, expiry, reserve }))
+    {
+        if (expiry != NoExpiry)
+            expiries_.Remove(expiry);
+        if (reserve != NoReserve)
+            reserves_.Release(reserve);
+        orderPool_.Release(handle);
+        return false;
+    }
+
+    // Queue the order at its price level
+    auto& level = candidate.GetSide() == Side::Buy ? bids_.GetOrAdd(candidate.GetPrice()) : asks_.GetOrAdd(candidate.GetPrice());
+    level.orders_.PushBack(handle);
+
+    OnOrderAdded(level, orderPool_[handle]);
+    return true;
+}
+
+// Function to read back the deadline of a resting order, which only the expiry index keeps
+Timestamp Orderbook::ExpiryOf(const OrderEntry& entry) const
+{
+    if (entry.expiry_ == NoExpiry)
+        return 0;
+
+    const auto deadline = expiries_.Deadline(entry.expiry_);
+    return deadline == ExpiryIndex::SessionExpiry ? 0 : deadline;
+}
+
+// Function to cancel an order by ID
+void Orderbook::CancelOrder(OrderId orderId)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    CancelOrderInternal(orderId);
+}
+
+// Function to modify an order by cancelling it and adding the replacement
+Trades Orderbook::ModifyOrder(OrderModify order)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    Trades trades;
+    TradeCollector sink{ trades };
+    ModifyOrderInternal(order, sink);
+    return trades;
+}
+
+// Function to modify an order and report its fills straight to `sink`
+void Orderbook::ModifyOrder(const OrderModify& order, ExecutionSink& sink)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    ModifyOrderInternal(order, sink);
+}
+
+// Function to modify a batch of orders under one lock, appending all fills to `trades`
+void Orderbook::ModifyOrders(std::span<const OrderModify> orders, Trades& trades)
+{
+    TradeCollector sink{ trades };
+    ModifyOrders(orders, sink);
+}
+
+// Function to modify a batch of orders under one lock, reporting all fills to `sink`
+void Orderbook::ModifyOrders(std::span<const OrderModify> orders, ExecutionSink& sink)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    for (const auto& order : orders)
+        ModifyOrderInternal(order, sink);
+}
+
+// Function to modify a single order with the lock already held
+void Orderbook::ModifyOrderInternal(const OrderModify& order, ExecutionSink& sink)
+{
+    const auto entry = orders_.Find(order.GetOrderId());
+    if (entry == nullptr)
+        return Reject(sink, order.GetOrderId(), RejectReason::UnknownOrder);
+
+    stats_.Count(OrderbookCounter::OrdersModified);
+
+    // Same side and price with no more quantity than is still open, shown or hidden: shrink the order where it stands
+    // and keep its priority
+    auto& resting = orderPool_[entry->order_];
+    auto* reserve = entry->reserve_ != NoReserve ? &reserves_[entry->reserve_] : nullptr;
+    const Quantity hidden = reserve != nullptr ? reserve->hiddenQuantity_ : 0;
+    if (order.GetSide() == resting.GetSide() && order.GetPrice() == resting.GetPrice()
+        && order.GetQuantity() != 0 && order.GetQuantity() <= resting.GetRemainingQuantity() + hidden)
+    {
+        auto reduction = resting.GetRemainingQuantity() + hidden - order.GetQuantity();
+        if (reduction == 0)
+            return;
+
+        // An iceberg gives up hidden quantity first, so its shown slice and the level only change once the reserve is gone
+        if (hidden != 0)
+        {
+            const auto fromHidden = std::min(reduction, hidden);
+            reserve->hiddenQuantity_ -= fromHidden;
+            resting.ReduceHidden(fromHidden);
+            reduction -= fromHidden;
+        }
+
+        if (reduction != 0)
+        {
+            auto& level = resting.GetSide() == Side::Buy ? bids_.At(resting.GetPrice()) : asks_.At(resting.GetPrice());
+            level.orders_.Reduce(entry->order_, reduction);
+            OnOrderReduced(level, resting, reduction);
+        }
+
+        UpdateTopOfBook();
+        return;
+    }
+
+    // Anything else is a cancel/replace, which keeps the type, expiry and display quantity of the original order
+    const auto orderType = resting.GetOrderType();
+    const auto expiry = ExpiryOf(*entry);
+    const Quantity display = reserve != nullptr ? reserve->displayQuantity_ : 0;
+
+    // The replace is published as one change, so no reader sees the book without the order: the top of book only once
+    // the replacement is in, and a level the replacement goes back to only in its final state
+    const bool sameLevel = order.GetSide() == resting.GetSide() && order.GetPrice() == resting.GetPrice();
+    const auto& level = resting.GetSide() == Side::Buy ? bids_.At(resting.GetPrice()) : asks_.At(resting.GetPrice());
+    const LevelUpdate withoutOrder{ resting.GetSide(), resting.GetPrice(), level.quantity_ - resting.GetRemainingQuantity(), level.count_ - 1 };
+
+    auto* const marketDataSink = marketDataSink_;
+    if (sameLevel)
+        marketDataSink_ = nullptr;
+    CancelOrderInternal(order.GetOrderId(), false);
+    marketDataSink_ = marketDataSink;
+
+    AddOrderInternal(order.ToOrder(orderType, expiry, display), sink);
+
+    // A replacement that was turned away never reported the level it left
+    if (sameLevel && marketDataSink_ != nullptr && !orders_.Contains(order.GetOrderId()))
+        marketDataSink_->OnLevelUpdate(withoutOrder);
+
+    UpdateTopOfBook();
+}
+
+// Function to apply a mixed batch of commands under one lock, appending all fills to `trades`
+void Orderbook::Execute(std::span<const Command> commands, Trades& trades)
+{
+    TradeCollector sink{ trades };
+    Execute(commands, sink);
+}
+
+// Function to apply a mixed batch of commands under one lock, reporting all fills to `sink`
+void Orderbook::Execute(std::span<const Command> commands, ExecutionSink& sink)
+{
+    auto ordersLock = LockOrders();
+    SyncClock();
+
+    for (const auto& command : commands)
+        ExecuteInternal(command, sink);
+}
+
+// Function to apply a single command with the lock already held
+void Orderbook::ExecuteInternal(const Command& command, ExecutionSink& sink)
+{
+    switch (command.type_)
+    {
+    case CommandType::Add:
+        AddOrderInternal(command.ToOrder(), sink);
+        break;
+    case CommandType::Cancel:
+        if (!CancelOrderInternal(command.orderId_))
+            Reject(sink, command.orderId_, RejectReason::UnknownOrder);
+        break;
+    case CommandType::Modify:
+        ModifyOrderInternal(command.ToOrderModify(), sink);
+        break;
+    case CommandType::CancelGoodForDay:
+        CancelGoodForDayOrdersInternal();
+        break;
+    case CommandType::AdvanceTime:
+        AdvanceTimeInternal(command.timestamp_);
+        break;
+    }
+}
+
+// Function to get the number of resting orders
+std::size_t Orderbook::Size() const
+{
+    auto ordersLock = LockOrders();
+    return orders_.Size();
+}
+
+// Function to total the memory held by the book's order storage and indexes
+std::size_t Orderbook::MemoryUsage() const
+{
+    auto ordersLock = LockOrders();
+    return orderPool_.MemoryUsage() + reserves_.MemoryUsage() + orders_.MemoryUsage() + expiries_.MemoryUsage() + bids_.MemoryUsage() + asks_.MemoryUsage();
+}
+
+// Function to build an aggregated view of every price level
+OrderbookLevelInfos Orderbook::GetOrderInfos() const
+{
+    // A one-off view is sized exactly; the refill below only grows buffers that are too small
+    OrderbookLevelInfos infos;
+    {
+        auto ordersLock = LockOrders();
+        infos.bids_.reserve(bids_.Size());
+        infos.asks_.reserve(asks_.Size());
+    }
+
+    GetOrderInfos(infos);
+    return infos;
+}
+
+// Function to refill a caller-owned view of every price level; once its buffers are large enough it never allocates
+void Orderbook::GetOrderInfos(OrderbookLevelInfos& infos) const
+{
+    auto ordersLock = LockOrders();
+
+    // Buffers grow with headroom, so a book that keeps gaining a level at a time does not reallocate on every call
+    auto Prepare = [](LevelInfos& buffer, std::size_t levels)
+    {
+        buffer.clear();
+        if (buffer.capacity() < levels)
+            buffer.reserve(2 * levels);
+    };
+
+    Prepare(infos.bids_, bids_.Size());
+    Prepare(infos.asks_, asks_.Size());
+
+    // Each level already carries its total quantity, so no order queue is walked
+    for (const auto& [price, level] : bids_)
+        infos.bids_.push_back(LevelInfo{ price, level.quantity_ });
+
+    for (const auto& [price, level] : asks_)
+        infos.asks_.push_back(LevelInfo{ price, level.quantity_ });
+}
+
+// Function to read the cached top of book without taking the orders mutex
+BestBidOffer Orderbook::GetBestBidOffer() const
+{
+    return publishedTopOfBook_.Load();
+}
+
+// Function to read the published depth without taking the orders mutex
+DepthSnapshot Orderbook::GetPublishedDepth() const
+{
+    return publishedDepthOfBook_.Load();
+}
+
+// Function to copy the instrumentation without taking the orders mutex
+OrderbookStats Orderbook::GetStats() const
+{
+    return stats_.Snapshot();
+}
+
+// Function to copy up to `levels` of the best levels per side into caller-provided buffers
+DepthCount Orderbook::GetDepth(std::size_t levels, std::span<LevelInfo> bids, std::span<LevelInfo> asks) const
+{
+    // The critical section is bounded by the requested depth, not by the size of the book
+    auto ordersLock = LockOrders();
+
+    auto CopyLevels = [levels](const auto& side, std::span<LevelInfo> buffer)
+    {
+        const auto limit = std::min(levels, buffer.size());
+        std::size_t count = 0;
+
+        for (const auto& [price, level] : side)
+        {
+            if (count == limit)
+                break;
+
+            buffer[count++] = LevelInfo{ price, level.quantity_ };
+        }
+
+        return count;
+    };
+
+    return DepthCount{ CopyLevels(bids_, bids), CopyLevels(asks_, asks) };
+}
+
+// Function to copy every resting order, level by level in time priority, for a snapshot
+void Orderbook::CaptureSnapshot(BookSnapshot& snapshot) const
+{
+    auto ordersLock = LockOrders();
+
+    snapshot.time_ = now_;
+    snapshot.orders_.clear();
+    snapshot.orders_.reserve(orders_.Size());
+
+    auto CopySide = [this, &snapshot](const auto& side)
+    {
+        for (const auto& [price, level] : side)
+            for (const auto& order : level.orders_)
+            {
+                // Only a deadline or an iceberg reserve needs the ID index; everything else is in the resting record
+                const auto* entry = order.GetOrderType() == OrderType::GoodTillDate || order.IsIceberg() ? orders_.Find(order.GetOrderId()) : nullptr;
+                const auto reserve = entry != nullptr && entry->reserve_ != NoReserve ? reserves_[entry->reserve_] : OrderReserve{ };
+
+                snapshot.orders_.push_back(SnapshotOrder{ order.GetOrderId(), entry != nullptr ? ExpiryOf(*entry) : Timestamp{ 0 }, order.GetPrice(),
+                    order.GetInitialQuantity(), order.GetRemainingQuantity() + reserve.hiddenQuantity_,
+                    static_cast<std::uint8_t>(order.GetOrderType()), static_cast<std::uint8_t>(order.GetSide()), { },
+                    reserve.displayQuantity_, order.GetRemainingQuantity() });
+            }
+    };
+
+    CopySide(bids_);
+    CopySide(asks_);
+}
+
+// Function to rebuild an empty book from snapshot orders, queueing them directly without matching
+void Orderbook::RestoreSnapshot(Timestamp time, std::span<const SnapshotOrder> orders)
+{
+    auto ordersLock = LockOrders();
+
+    if (orders_.Size() != 0)
+        Raise(std::logic_error("Orderbook must be empty to restore a snapshot."));
+
+    // Restore the clock first so the session and deadlines line up with the book that was saved
+    AdvanceTimeInternal(time);
+
+    for (const auto& saved : orders)
+    {
+        const auto side = static_cast<Side>(saved.side_);
+        if (side == Side::Buy ? !bids_.Accepts(saved.price_) : !asks_.Accepts(saved.price_))
+            Raise(std::invalid_argument(std::format("Snapshot order ({}) is outside this book's price band.", saved.orderId_)));
+
+        // A slice larger than what is left, or a partly hidden order without a slice size, cannot be rebuilt
+        if (saved.shownQuantity_ == 0 || saved.shownQuantity_ > saved.remainingQuantity_
+            || (saved.shownQuantity_ < saved.remainingQuantity_ && saved.displayQuantity_ == 0))
+            Raise(std::invalid_argument(std::format("Snapshot order ({}) has inconsistent iceberg quantities.", saved.orderId_)));
+
+        // Orders arrive in time priority, so appending each one rebuilds every level queue as it was
+        Order order{ static_cast<OrderType>(saved.orderType_), static_cast<OrderId>(saved.orderId_), side,
+            static_cast<Price>(saved.price_), static_cast<Quantity>(saved.initialQuantity_), saved.expiry_,
+            static_cast<Quantity>(saved.displayQuantity_) };
+        order.Fill(static_cast<Quantity>(saved.initialQuantity_ - saved.remainingQuantity_));
+
+        if (!RestOrder(order, static_cast<Quantity>(saved.shownQuantity_)))
+            Raise(std::invalid_argument(std::format("Snapshot order ({}) appears more than once.", saved.orderId_)));
+    }
+
+    UpdateTopOfBook();
+}
+
+// The typed entry points, one instantiation per order type
+template Trades Orderbook::AddOrder<OrderType::GoodTillCancel>(const Order& order);
+template Trades Orderbook::AddOrder<OrderType::FillAndKill>(const Order& order);
+template Trades Orderbook::AddOrder<OrderType::FillOrKill>(const Order& order);
+template Trades Orderbook::AddOrder<OrderType::GoodForDay>(const Order& order);
+template Trades Orderbook::AddOrder<OrderType::Market>(const Order& order);
+template Trades Orderbook::AddOrder<OrderType::GoodTillDate>(const Order& order);
+template void Orderbook::AddOrder<OrderType::GoodTillCancel>(const Order& order, ExecutionSink& sink);
+template void Orderbook::AddOrder<OrderType::FillAndKill>(const Order& order, ExecutionSink& sink);
+template void Orderbook::AddOrder<OrderType::FillOrKill>(const Order& order, ExecutionSink& sink);
+template void Orderbook::AddOrder<OrderType::GoodForDay>(const Order& order, ExecutionSink& sink);
+template void Orderbook::AddOrder<OrderType::Market>(const Order& order, ExecutionSink& sink);
+template void Orderbook::AddOrder<OrderType::GoodTillDate>(const Order& order, ExecutionSink& sink);
@@ -0,0 +1,155 @@
+#pragma once // Ensures this file is included only once during compilation.
+
+#include <mutex>
+#include <limits>
+#include <memory_resource>
+#include <span>
+
+#include "Usings.h" // Custom type aliases and utilities.
+#include "Order.h" // Order class definition.
+#include "RestingOrder.h" // Compact record of an order while it rests.
+#include "OrderQueue.h" // FIFO queue of orders at a price level.
+#include "PriceLevels.h" // Map- or ladder-backed price levels for one side.
+#include "OrderbookConfig.h" // Construction-time options.
+#include "OrderIndex.h" // Flat order-ID table.
+#include "ExpiryIndex.h" // Lists of orders that can expire.
+#include "OrderModify.h" // Order modification class definition.
+#include "OrderbookLevelInfos.h" // Class providing order book level information.
+#include "Trade.h" // Trade-related definitions and data structures.
+#include "Command.h" // Fixed-size requests for batched execution.
+#include "ExecutionSink.h" // Callback interface for fills and rejects.
+#include "MarketDataSink.h" // Callback interface for L2 deltas.
+#include "BestBidOffer.h" // Top-of-book and depth query results.
+#include "Seqlock.h" // Lock-free publication of the top of book.
+#include "Snapshot.h" // Flat full-book snapshots.
+#include "OrderbookStats.h" // Hot-path counters and latency histograms.
+
+// The `Orderbook` class manages the collection of buy and sell orders, tracks order book levels, 
+// and facilitates the matching and execution of trades.
+class Orderbook
+{
+private:
+    // Represents an entry in the order book, tying an order to its location in the price level.
+    struct OrderEntry
+    {
+        OrderHandle order_{ NoOrder }; // Pooled order, which is also its own node in the level queue.
+        ExpiryHandle expiry_{ NoExpiry }; // Node in the expiry index, for orders that can expire.
+        ReserveHandle reserve_{ NoReserve }; // Hidden part of an iceberg order.
+    };
+
+    // Actions to track updates to levels: adding, removing, or matching orders.
+    enum class LevelAction
+    {
+        Add,    // Adding a new order.
+        Remove, // Removing an existing order.
+        Match,  // Matching orders for execution.
+        Reduce, // Shrinking a resting order in place.
+    };
+
+    // Internal data members
+    RestingOrderPool orderPool_; // Storage for every resting order; declared first because the levels resolve handles through it.
+    OrderReservePool reserves_; // Hidden parts of resting iceberg orders.
+    std::pmr::unsynchronized_pool_resource arena_; // Recycles map nodes and queue arrays; unsynchronized, since only the book's writer allocates.
+    PriceLevels<Side::Buy> bids_; // Buy orders, best (highest) price first.
+    PriceLevels<Side::Sell> asks_; // Sell orders, best (lowest) price first.
+    OrderIndex<OrderEntry> orders_; // Mapping of orders by ID for quick lookup.
+    ExpiryIndex expiries_; // "Good-For-Day" and "Good-Till-Date" orders, by expiry.
+    OrderIds expiring_; // Scratch list for the expiry sweeps, kept so its capacity is reused.
+    mutable std::mutex ordersMutex_; // Mutex for thread-safe operations on the orders.
+    Synchronization synchronization_; // Whether public calls lock `ordersMutex_`.
+    MarketDataSink* marketDataSink_; // Optional receiver of L2 deltas.
+    const SessionClock* clock_; // Optional time source read by every mutating call.
+    const SessionCalendar* calendar_; // Optional session closes for "Good-For-Day" orders.
+    Timestamp now_{ std::numeric_limits<Timestamp>::min() }; // Latest time the book has been advanced to.
+    Timestamp nextClose_{ std::numeric_limits<Timestamp>::min() }; // Next session close; the minimum until the first time is seen.
+    Timestamp nextExpiry_{ std::numeric_limits<Timestamp>::min() }; // Earliest time at which anything may expire.
+    BestBidOffer topOfBook_{ }; // Writer's copy of the current top of book.
+    Seqlock<BestBidOffer> publishedTopOfBook_; // Top of book as seen by lock-free readers.
+    std::size_t publishedDepth_; // Levels per side kept in `publishedDepthOfBook_`; zero when it is not maintained.
+    DepthSnapshot depthOfBook_{ }; // Writer's copy of the latest published depth.
+    Seqlock<DepthSnapshot> publishedDepthOfBook_; // Depth and shape as seen by lock-free readers.
+    mutable OrderbookInstrumentation stats_; // Written by whoever holds the book, read by `GetStats` from anywhere.
+
+    // Internal helper methods
+    void SyncClock(); // Advances the book to its clock, if it has one.
+    void AdvanceTimeInternal(Timestamp now); // Internal logic for expiring whatever is due at `now`.
+    bool CancelOrderInternal(OrderId orderId, bool publish = true); // Internal logic for cancelling a single order; false if it was not resting. Without `publish`, the top of book is left for the caller to republish.
+    void Reject(ExecutionSink& sink, OrderId orderId, RejectReason reason); // Counts a reject and reports it to the sink.
+    void AddOrderInternal(const Order& order, ExecutionSink& sink); // Dispatches a single order to the path for its type.
+    template <OrderType Type>
+    void AddOrderInternal(const Order& order, ExecutionSink& sink); // Internal logic for adding a single order of one type.
+    void ModifyOrderInternal(const OrderModify& order, ExecutionSink& sink); // Internal logic for modifying a single order.
+    void ExecuteInternal(const Command& command, ExecutionSink& sink); // Internal logic for applying a single command.
+    void CancelGoodForDayOrdersInternal(); // Internal logic for the "Good-For-Day" sweep.
+    void ExpireOrdersInternal(Timestamp now); // Internal logic for expiring due "Good-Till-Date" orders.
+    void RemoveFilledOrder(OrderId orderId, OrderHandle order); // Forgets a filled order already unlinked from its level.
+    bool RestOrder(const Order& order, Quantity shown); // Queues an order at its level showing `shown`, without matching; false for a duplicate ID.
+    Timestamp ExpiryOf(const OrderEntry& entry) const; // The deadline of a "Good-Till-Date" order, zero for any other.
+    void UpdateTopOfBook(); // Refreshes and republishes the cached top of book after a mutation.
+    void UpdateDepthOfBook(); // Refreshes and republishes the depth snapshot, if the book keeps one.
+    std::unique_lock<std::mutex> LockOrders() const; // Locks `ordersMutex_` unless the book is single-writer.
+    void OnOrderCancelled(PriceLevel& level, const RestingOrder& order); // Handles the event of an order being cancelled.
+    void OnOrderAdded(PriceLevel& level, const RestingOrder& order); // Handles the event of an order being added.
+    void OnOrderMatched(PriceLevel& level, Side side, Price price, Quantity quantity, bool filled); // Handles matched orders.
+    void OnOrderReduced(PriceLevel& level, const RestingOrder& order, Quantity quantity); // Handles an in-place quantity-down amend.
+    void OnOrderRefreshed(PriceLevel& level, Side side, Price price, Quantity filled, Quantity shown); // Handles an iceberg showing its next slice.
+    void UpdateLevelData(PriceLevel& level, Side side, Price price, Quantity quantity, LevelAction action); // Updates level aggregates and publishes the delta.
+
+    // Matching logic
+    bool CanFullyFill(Side side, Price price, Quantity quantity) const; // Checks if an order can be fully filled.
+    bool CanMatch(Side side, Price price) const; // Checks if orders can be matched at a given price.
+    template <Side RestingSide>
+    Quantity Sweep(PriceLevels<RestingSide>& levels, const Order& order, ExecutionSink& sink); // Matches an incoming order against the opposite side; returns the quantity filled.
+    void MatchFront(PriceLevel& level, Side side, Price price, Quantity quantity); // Applies one fill to the front order of a level, refreshing an iceberg.
+
+public:
+    // Constructors and destructor
+    explicit Orderbook(const OrderbookConfig& config = { }); // Builds the book with the given storage options.
+    Orderbook(const Orderbook&) = delete; // Copy constructor is deleted to prevent copying.
+    void operator=(const Orderbook&) = delete; // Copy assignment is deleted to prevent copying.
+    Orderbook(Orderbook&&) = delete; // Move constructor is deleted to prevent moving.
+    void operator=(Orderbook&&) = delete; // Move assignment is deleted to prevent moving.
+
+    // Public interface for managing orders
+    Trades AddOrder(const Order& order); // Adds a new order to the book.
+    void CancelOrder(OrderId orderId); // Cancels an existing order by ID.
+    Trades ModifyOrder(OrderModify order); // Modifies an existing order.
+    void AddOrder(const Order& order, ExecutionSink& sink); // Adds a new order, reporting fills to the sink.
+    void ModifyOrder(const OrderModify& order, ExecutionSink& sink); // Modifies an order, reporting fills to the sink.
+
+    // Typed entry points: `Type` is fixed at compile time, so each type gets its own path with no branching on it.
+    // Instantiated in Orderbook.cpp for every `OrderType`; an order of another type is rejected with `RejectReason::WrongOrderType`.
+    template <OrderType Type>
+    Trades AddOrder(const Order& order); // Adds a new order of type `Type` to the book.
+    template <OrderType Type>
+    void AddOrder(const Order& order, ExecutionSink& sink); // Adds a new order of type `Type`, reporting fills to the sink.
+
+    void CancelGoodForDayOrders(); // Cancels every resting "Good-For-Day" order.
+    void ExpireOrders(Timestamp now); // Cancels every "Good-Till-Date" order due at or before `now`.
+    void AdvanceTime(Timestamp now); // Moves the book to `now`, expiring "Good-For-Day" orders across a session close and due "Good-Till-Date" orders.
+    Timestamp NextExpiry() const; // Earliest time at which `AdvanceTime` may change the book; calls before it are no-ops.
+
+    // Batch interface: one lock per call, with fills appended to a caller-owned, reusable buffer or reported to a sink
+    void AddOrders(std::span<const Order> orders, Trades& trades); // Adds orders in sequence.
+    void AddOrders(std::span<const Order> orders, ExecutionSink& sink); // Adds orders in sequence.
+    void CancelOrders(std::span<const OrderId> orderIds); // Cancels orders by ID.
+    void ModifyOrders(std::span<const OrderModify> orders, Trades& trades); // Modifies orders in sequence.
+    void ModifyOrders(std::span<const OrderModify> orders, ExecutionSink& sink); // Modifies orders in sequence.
+    void Execute(std::span<const Command> commands, Trades& trades); // Applies a mixed sequence of commands.
+    void Execute(std::span<const Command> commands, ExecutionSink& sink); // Applies a mixed sequence of commands, reporting unknown cancels as rejects too.
+
+    // Utility methods
+    std::size_t Size() const; // Returns the total number of orders in the book.
+    bool HasClock() const { return clock_ != nullptr; } // Whether mutating calls read a clock, rather than taking time only from `AdvanceTime`.
+    std::size_t MemoryUsage() const; // Bytes held by the order and reserve pools, the ID index, the expiry index and the levels.
+    OrderbookLevelInfos GetOrderInfos() const; // Retrieves detailed information about order book levels.
+    void GetOrderInfos(OrderbookLevelInfos& infos) const; // Refills a caller-owned view of every level, reusing its buffers.
+    BestBidOffer GetBestBidOffer() const; // Lock-free read of the cached best bid and offer.
+    DepthSnapshot GetPublishedDepth() const; // Lock-free read of the top `OrderbookConfig::publishedDepth_` levels and the book's shape.
+    OrderbookStats GetStats() const; // Lock-free copy of the instrumentation; zeros when built with ORDERBOOK_STATS=0.
+    DepthCount GetDepth(std::size_t levels, std::span<LevelInfo> bids, std::span<LevelInfo> asks) const; // Copies the top `levels` of each side.
+
+    // Persistence
+    void CaptureSnapshot(BookSnapshot& snapshot) const; // Copies the book's time and resting orders, reusing the snapshot's buffer.
+    void RestoreSnapshot(Timestamp time, std::span<const SnapshotOrder> orders); // Rebuilds an empty book without matching; raises a `Failure.h` error on bad input.
+};
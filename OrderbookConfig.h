@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "Usings.h"
+#include "OrderIndex.h"
+#include "OrderQueue.h"
+#include "SessionClock.h"
+
+class MarketDataSink;
+
+// How an order book stores its price levels.
+enum class LevelStorage
+{
+    Map,    // Ordered tree keyed by price; suits wide or sparse price ranges.
+    Ladder, // Contiguous array indexed by tick within a bounded price band.
+};
+
+// Who may call into an order book.
+enum class Synchronization
+{
+    Locked,       // Any thread; every public call takes the book's mutex.
+    SingleWriter, // One owning thread; no locks.
+};
+
+// Construction-time options for an `Orderbook`.
+struct OrderbookConfig
+{
+    std::size_t orderCapacity_{ 1 << 16 };       // Resting orders to preallocate (and grow by) in the order pool.
+    LevelStorage levelStorage_{ LevelStorage::Map }; // Price level container used for both sides.
+    Price basePrice_{ 0 };                       // Ladder only: lowest price in the band.
+    Price tickSize_{ 1 };                        // Ladder only: price increment between adjacent levels.
+    std::size_t levelCount_{ 0 };                // Ladder only: number of ticks in the band.
+    OrderLayout orderLayout_{ OrderLayout::Intrusive }; // How each level queues its orders; columnar suits deep levels swept by large orders.
+    OrderIndexMode orderIndexMode_{ OrderIndexMode::Hashed }; // How order IDs are looked up.
+    Synchronization synchronization_{ Synchronization::Locked }; // Locking model for the public API.
+    MarketDataSink* marketDataSink_{ nullptr };  // Receives L2 deltas on the mutating thread; must outlive the book.
+    bool latencyHistograms_{ false };            // Keep the latency and fills-per-match histograms `GetStats` reports, about 55 KB per book; the counters are kept regardless.
+    std::size_t publishedDepth_{ 0 };            // Levels per side republished for `GetPublishedDepth` after every mutation, up to `DepthSnapshot::MaxLevels`; 0 publishes nothing.
+    const SessionClock* clock_{ &SystemClock::Instance() }; // Read by every mutating call to expire due orders; null leaves time to `AdvanceTime`.
+    const SessionCalendar* calendar_{ &DailyCloseCalendar::Default() }; // Session closes that expire "Good-For-Day" orders; null never expires them.
+    std::pmr::memory_resource* memory_{ nullptr }; // Where the order pools, the ID index, the book's arena and its histograms get their memory, e.g. a `PageMemory`; must outlive the book. Null uses the global allocator.
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <utility>
+
+#include "LevelInfo.h"
+
+class OrderbookLevelInfos
+{
+public:
+    OrderbookLevelInfos() = default;
+
+    OrderbookLevelInfos(LevelInfos bids, LevelInfos asks)
+        : bids_{ std::move(bids) }
+        , asks_{ std::move(asks) }
+    { }
+
+    const LevelInfos& GetBids() const { return bids_; }
+    const LevelInfos& GetAsks() const { return asks_; }
+
+private:
+    friend class Orderbook; // Refills the buffers in place.
+
+    LevelInfos bids_;
+    LevelInfos asks_;
+};
\ No newline at end of file
@@ -0,0 +1,421 @@
+#include "OrderbookManager.h"
+#include "ThreadAffinity.h"
+
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <stdexcept>
+
+// Constructor: creates the shards; threads start in Start once instruments are registered
+OrderbookManager::OrderbookManager(OrderbookManagerConfig config)
+    : config_{ std::move(config) }
+{
+    if (config_.shardCount_ == 0)
+        config_.shardCount_ = 1;
+
+    // Shards get their own page memory when pinned, or when asked for huge or pre-faulted pages
+    const bool shardMemory = !config_.cpus_.empty() || config_.pageSize_ != PageSize::Small || config_.prefault_;
+
+    shards_.reserve(config_.shardCount_);
+    for (std::size_t i = 0; i < config_.shardCount_; ++i)
+    {
+        const auto waitPolicy = config_.waitPolicies_.empty() ? WaitPolicy{ } : config_.waitPolicies_[i % config_.waitPolicies_.size()];
+        shards_.push_back(std::make_unique<Shard>(config_.commandCapacity_, waitPolicy));
+        shards_.back()->batch_.reserve(config_.batchSize_ * 2);
+
+        if (shardMemory)
+        {
+            const int node = config_.cpus_.empty() ? -1 : NumaNodeOfCpu(config_.cpus_[i % config_.cpus_.size()]);
+            shards_.back()->memory_ = std::make_unique<PageMemory>(PageMemoryConfig{ config_.pageSize_, node, config_.prefault_ });
+        }
+    }
+}
+
+// Destructor: stops every thread
+OrderbookManager::~OrderbookManager()
+{
+    Stop();
+}
+
+// Function to create the single-writer book for an instrument on its shard
+bool OrderbookManager::AddInstrument(InstrumentId instrumentId, OrderbookConfig config)
+{
+    if (running_.load(std::memory_order_acquire))
+        return false;
+
+    // The shard thread is the only writer, and it advances every book from the manager's clock
+    config.synchronization_ = Synchronization::SingleWriter;
+    config.clock_ = nullptr;
+    auto& shard = ShardFor(instrumentId);
+    auto& books = shard.books_;
+    if (books.contains(instrumentId))
+        return false;
+
+    // The book's preallocated pool slab, ID index and ladder are placed, and pre-faulted, here rather than on first use
+    if (config.memory_ == nullptr)
+        config.memory_ = shard.memory_.get();
+
+    // The book object itself, with its top of book and counters, goes in the same memory rather than the registering thread's heap
+    auto* const memory = config.memory_ != nullptr ? config.memory_ : std::pmr::new_delete_resource();
+    std::unique_ptr<Orderbook, BookDeleter> orderbook{ std::pmr::polymorphic_allocator<Orderbook>{ memory }.new_object<Orderbook>(config), BookDeleter{ memory } };
+
+    // A new book has not seen a time yet, so it is due as soon as the shard has one
+    auto& book = books.emplace(instrumentId, ShardBook{ std::move(orderbook) }).first->second;
+    book.slot_ = shard.schedule_.size();
+    shard.schedule_.push_back(&book);
+    Reschedule(shard, book);
+    return true;
+}
+
+// Function to start the shard threads
+void OrderbookManager::Start()
+{
+    if (running_.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    for (std::size_t i = 0; i < shards_.size(); ++i)
+        shards_[i]->thread_ = std::thread{ [this, i] { RunShard(i); } };
+}
+
+// Function to drain and join every thread
+void OrderbookManager::Stop()
+{
+    if (!running_.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    for (auto& shard : shards_)
+        shard->waiter_.Notify();
+    for (auto& shard : shards_)
+        shard->thread_.join();
+}
+
+// Function to enqueue a decoded batch, stopping at the first command that does not fit
+std::size_t OrderbookManager::Submit(std::span<const Command> commands)
+{
+    std::size_t submitted = 0;
+    for (const auto& command : commands)
+    {
+        if (!Submit(command))
+            break;
+        ++submitted;
+    }
+
+    return submitted;
+}
+
+// Function to route a command to its instrument's shard
+bool OrderbookManager::Submit(const Command& command)
+{
+    auto& shard = ShardFor(command.instrumentId_);
+    if (!shard.commands_.TryPush(command))
+        return false;
+
+    shard.waiter_.Notify();
+    return true;
+}
+
+// Function to hand a command that applies to every book to all shards
+void OrderbookManager::Broadcast(const Command& command)
+{
+    for (auto& shard : shards_)
+    {
+        while (!shard->commands_.TryPush(command))
+            std::this_thread::yield();
+        shard->waiter_.Notify();
+    }
+}
+
+OrderbookManager::Shard& OrderbookManager::ShardFor(InstrumentId instrumentId)
+{
+    return *shards_[ShardOf(instrumentId)];
+}
+
+// Shard thread main loop: apply commands in batches and flush each batch's events at once
+void OrderbookManager::RunShard(std::size_t index)
+{
+    auto& shard = *shards_[index];
+
+    if (!config_.cpus_.empty())
+        PinCurrentThread(config_.cpus_[index % config_.cpus_.size()]);
+
+    Command command;
+
+    while (true)
+    {
+        // Expiry happens here in the loop, between batches, rather than on a timer thread
+        if (config_.clock_ != nullptr)
+            AdvanceShard(shard, config_.clock_->Now());
+
+        if (shard.snapshotRequested_.load(std::memory_order_acquire))
+            ServeSnapshots(shard);
+
+        std::size_t applied = 0;
+        while (applied < config_.batchSize_ && shard.commands_.TryPop(command))
+        {
+            ApplyCommand(shard, command);
+            ++applied;
+        }
+
+        if (!shard.batch_.empty())
+        {
+            if (config_.onEvents_)
+                config_.onEvents_(index, shard.batch_);
+            shard.batch_.clear();
+        }
+
+        if (applied != 0)
+        {
+            shard.waiter_.Reset();
+            continue;
+        }
+
+        // Only exit once the ring is empty so accepted commands are never lost
+        if (!running_.load(std::memory_order_acquire))
+        {
+            if (!shard.commands_.TryPop(command))
+                break;
+
+            ApplyCommand(shard, command);
+            continue;
+        }
+
+        if (config_.onIdle_)
+            config_.onIdle_(index);
+
+        // Wait as the shard's policy says; a blocking shard rechecks for commands, snapshot requests and shutdown before it sleeps
+        shard.waiter_.Idle([this, &shard]
+        {
+            return !shard.commands_.Empty() || shard.snapshotRequested_.load(std::memory_order_acquire) || !running_.load(std::memory_order_acquire);
+        });
+    }
+
+    if (!shard.batch_.empty() && config_.onEvents_)
+        config_.onEvents_(index, shard.batch_);
+    shard.batch_.clear();
+    // Requests that raced with shutdown still get the final books
+    ServeSnapshots(shard);
+}
+
+// Function to apply a command to the book it targets
+void OrderbookManager::ApplyCommand(Shard& shard, const Command& command)
+{
+    if (command.type_ == CommandType::CancelGoodForDay || command.type_ == CommandType::AdvanceTime)
+    {
+        // Sweeps and time are broadcast once per shard, so apply them to every book here
+        if (command.type_ == CommandType::CancelGoodForDay)
+        {
+            for (auto& [_, book] : shard.books_)
+            {
+                book.book_->CancelGoodForDayOrders();
+                Reschedule(shard, book);
+            }
+        }
+        else
+            AdvanceShard(shard, command.timestamp_);
+
+        shard.batch_.push_back(EngineEvent::Ack(command));
+        return;
+    }
+
+    // A command for an instrument nobody registered never reached a book, so it is refused rather than acknowledged
+    const auto found = shard.books_.find(command.instrumentId_);
+    if (found == shard.books_.end())
+    {
+        shard.batch_.push_back(EngineEvent::FromReject(command.orderId_, RejectReason::UnknownInstrument, command.instrumentId_));
+        return;
+    }
+
+    auto& book = found->second;
+
+    // A book that was not due may lag the shard's time, which it needs to judge the command, e.g. an expired "Good-Till-Date" order
+    if (shard.now_ != std::numeric_limits<Timestamp>::min())
+        book.book_->AdvanceTime(shard.now_);
+
+    // Fills and rejects land in the batch through the shard's OnTrade and OnReject
+    shard.instrumentId_ = command.instrumentId_;
+    book.book_->Execute(std::span{ &command, 1 }, shard);
+
+    // The command may have rested an order that expires sooner
+    Reschedule(shard, book);
+
+    shard.batch_.push_back(EngineEvent::Ack(command));
+}
+
+// Function to move a shard to `now`, advancing only the books with something due
+void OrderbookManager::AdvanceShard(Shard& shard, Timestamp now)
+{
+    shard.now_ = std::max(shard.now_, now);
+
+    // Each book advanced leaves with a deadline after `now`, so this stops at the first book that is not due
+    while (!shard.schedule_.empty() && shard.schedule_.front()->deadline_ <= shard.now_)
+    {
+        auto& book = *shard.schedule_.front();
+        book.book_->AdvanceTime(shard.now_);
+        Reschedule(shard, book);
+    }
+}
+
+// Function to restore the heap order around a book whose deadline may have moved either way
+void OrderbookManager::Reschedule(Shard& shard, ShardBook& book)
+{
+    auto& schedule = shard.schedule_;
+    book.deadline_ = book.book_->NextExpiry();
+
+    auto Place = [&schedule](ShardBook* entry, std::size_t slot)
+    {
+        schedule[slot] = entry;
+        entry->slot_ = slot;
+    };
+
+    // Towards the root while the parent is due later
+    auto slot = book.slot_;
+    while (slot != 0 && schedule[(slot - 1) / 2]->deadline_ > book.deadline_)
+    {
+        Place(schedule[(slot - 1) / 2], slot);
+        slot = (slot - 1) / 2;
+    }
+
+    // Otherwise towards the leaves while a child is due sooner
+    while (2 * slot + 1 < schedule.size())
+    {
+        auto child = 2 * slot + 1;
+        if (child + 1 < schedule.size() && schedule[child + 1]->deadline_ < schedule[child]->deadline_)
+            ++child;
+        if (schedule[child]->deadline_ >= book.deadline_)
+            break;
+
+        Place(schedule[child], slot);
+        slot = child;
+    }
+
+    Place(&book, slot);
+}
+
+// Function to bring the books that were not due up to the shard's time, e.g. so a snapshot records it
+void OrderbookManager::CatchUpShard(Shard& shard)
+{
+    if (shard.now_ == std::numeric_limits<Timestamp>::min())
+        return;
+
+    for (auto& [_, book] : shard.books_)
+        book.book_->AdvanceTime(shard.now_);
+}
+
+// Function to copy every book on a shard, on the thread that owns it
+std::vector<BookSnapshot> OrderbookManager::CaptureShard(const Shard& shard)
+{
+    std::vector<BookSnapshot> snapshots(shard.books_.size());
+
+    std::size_t i = 0;
+    for (const auto& [instrumentId, book] : shard.books_)
+    {
+        snapshots[i].instrumentId_ = instrumentId;
+        book.book_->CaptureSnapshot(snapshots[i++]);
+    }
+
+    return snapshots;
+}
+
+// Function to answer every pending snapshot request, between two batches
+void OrderbookManager::ServeSnapshots(Shard& shard)
+{
+    std::vector<std::promise<std::vector<BookSnapshot>>> requests;
+    {
+        std::scoped_lock snapshotLock{ shard.snapshotMutex_ };
+        requests.swap(shard.snapshotRequests_);
+        shard.snapshotRequested_.store(false, std::memory_order_relaxed);
+    }
+
+    if (requests.empty())
+        return;
+
+    CatchUpShard(shard);
+    auto snapshots = CaptureShard(shard);
+    for (std::size_t i = 1; i < requests.size(); ++i)
+        requests[i].set_value(snapshots);
+    requests.front().set_value(std::move(snapshots));
+}
+
+// Function to copy every book; running shards each pause only for their own copy
+std::vector<BookSnapshot> OrderbookManager::Snapshot()
+{
+    std::vector<BookSnapshot> snapshots;
+
+    if (!running_.load(std::memory_order_acquire))
+    {
+        for (const auto& shard : shards_)
+        {
+            CatchUpShard(*shard);
+            for (auto& book : CaptureShard(*shard))
+                snapshots.push_back(std::move(book));
+        }
+
+        return snapshots;
+    }
+
+    std::vector<std::future<std::vector<BookSnapshot>>> pending;
+    pending.reserve(shards_.size());
+    for (auto& shard : shards_)
+    {
+        std::scoped_lock snapshotLock{ shard->snapshotMutex_ };
+        pending.push_back(shard->snapshotRequests_.emplace_back().get_future());
+        shard->snapshotRequested_.store(true, std::memory_order_release);
+        shard->waiter_.Notify();
+    }
+
+    for (auto& future : pending)
+        for (auto& book : future.get())
+            snapshots.push_back(std::move(book));
+
+    return snapshots;
+}
+
+// Function to rebuild registered books from a snapshot, loading each shard's books on its own thread
+void OrderbookManager::Restore(const SnapshotReader& snapshot)
+{
+    if (running_.load(std::memory_order_acquire))
+        Raise(std::logic_error("OrderbookManager can only restore a snapshot before Start."));
+
+    // Group the books by shard, rejecting instruments that were never registered
+    std::vector<std::vector<const SnapshotBookView*>> work(shards_.size());
+    for (const auto& book : snapshot.Books())
+    {
+        if (!ShardFor(book.instrumentId_).books_.contains(book.instrumentId_))
+            Raise(std::invalid_argument(std::format("Snapshot instrument ({}) is not registered.", book.instrumentId_)));
+
+        work[ShardOf(book.instrumentId_)].push_back(&book);
+    }
+
+    // Shards share nothing, so their books can be rebuilt concurrently
+    std::vector<std::exception_ptr> errors(shards_.size());
+    std::vector<std::thread> loaders;
+    loaders.reserve(shards_.size());
+
+    for (std::size_t i = 0; i < shards_.size(); ++i)
+    {
+        loaders.emplace_back([this, i, &work, &errors]
+        {
+            ORDERBOOK_TRY
+            {
+                for (const auto* book : work[i])
+                    shards_[i]->books_.at(book->instrumentId_).book_->RestoreSnapshot(book->time_, book->orders_);
+            }
+            ORDERBOOK_CATCH_ALL
+            {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& loader : loaders)
+        loader.join();
+
+    for (const auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    // Restored books may have orders that expire before anything else on their shard
+    for (auto& shard : shards_)
+        for (auto& [_, book] : shard->books_)
+            Reschedule(*shard, book);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Usings.h"
+#include "Orderbook.h"
+#include "Command.h"
+#include "EngineEvent.h"
+#include "MpscRing.h"
+#include "ExecutionSink.h"
+#include "SessionClock.h"
+#include "Snapshot.h"
+#include "PageMemory.h"
+#include "WaitPolicy.h"
+
+// Receives the events one shard produced while applying a batch of commands, on that shard's thread.
+using EventBatchHandler = std::function<void(std::size_t shard, std::span<const EngineEvent> events)>;
+
+// Construction-time options for an `OrderbookManager`.
+struct OrderbookManagerConfig
+{
+    std::size_t shardCount_{ 1 };               // Worker threads; instruments are spread across them by ID.
+    std::vector<int> cpus_;                     // CPU to pin shard `i` to is `cpus_[i % size]`; empty leaves threads unpinned.
+    std::size_t commandCapacity_{ 1 << 16 };    // Inbound ring slots per shard.
+    std::size_t batchSize_{ 256 };              // Most commands a shard applies before flushing its events.
+    EventBatchHandler onEvents_;                // Batched trade and ack output; may be empty.
+    const SessionClock* clock_{ &SystemClock::Instance() }; // Read by each shard between batches; null leaves time to `Command::AdvanceTime`.
+    PageSize pageSize_{ PageSize::Small };      // Pages behind each shard's books; huge pages fall back to base pages where none are reserved.
+    bool prefault_{ false };                    // Fault in each shard's book memory as its instruments are added, not on first use.
+    std::vector<WaitPolicy> waitPolicies_;      // Shard `i` waits as `waitPolicies_[i % size]` says; empty uses the default policy for all.
+    std::function<void(std::size_t shard)> onIdle_; // Housekeeping run on a shard's thread after every empty poll, before it waits; may be empty.
+};
+
+// Owns many single-instrument books and runs them on a fixed set of pinned shard threads.
+// Each shard exclusively owns the books routed to it, so no book is ever locked, and each shard
+// advances its books from one shared clock between batches instead of running a timer thread.
+// A shard keeps its books in a heap by `Orderbook::NextExpiry`, so a poll with nothing due costs one comparison
+// however many instruments the shard holds; a book that is about to act is brought to the shard's time first.
+// Pinned shards keep their books, with their order pools, ID indexes and levels, in a `PageMemory` on their CPU's NUMA node,
+// so a matching thread only touches local memory. Each shard has its own wait policy, so latency-critical shards
+// can spin while cheap ones sleep.
+class OrderbookManager
+{
+private:
+    // Destroys a book and hands its memory back to the resource it was placed in.
+    struct BookDeleter
+    {
+        std::pmr::memory_resource* memory_{ std::pmr::new_delete_resource() };
+
+        void operator()(Orderbook* book) const { std::pmr::polymorphic_allocator<Orderbook>{ memory_ }.delete_object(book); }
+    };
+
+    // A shard's book with its place in the shard's expiry schedule.
+    struct ShardBook
+    {
+        std::unique_ptr<Orderbook, BookDeleter> book_; // Placed in the shard's memory, like the book's pools.
+        Timestamp deadline_{ }; // The book's `NextExpiry` as last scheduled.
+        std::size_t slot_{ }; // Position in `Shard::schedule_`.
+    };
+
+    struct Shard final : ExecutionSink
+    {
+        Shard(std::size_t commandCapacity, const WaitPolicy& waitPolicy) : commands_{ commandCapacity }, waiter_{ waitPolicy } { }
+
+        // Appends each fill of the current command to the batch
+        void OnTrade(const Trade& trade) override { batch_.push_back(EngineEvent::FromTrade(trade, instrumentId_)); }
+
+        // Appends each reject of the current command to the batch
+        void OnReject(OrderId orderId, RejectReason reason) override { batch_.push_back(EngineEvent::FromReject(orderId, reason, instrumentId_)); }
+
+        std::unique_ptr<PageMemory> memory_; // Backs the books below, so it is declared first and outlives them; null uses the global allocator.
+        std::unordered_map<InstrumentId, ShardBook> books_; // Books owned by this shard.
+        std::vector<ShardBook*> schedule_; // Min-heap of the books by deadline, so a poll only touches books that are due.
+        Timestamp now_{ std::numeric_limits<Timestamp>::min() }; // Latest time the shard has been moved to.
+        MpscRing<Command> commands_; // Inbound commands from any producer.
+        IdleWaiter waiter_; // How the shard thread waits for commands.
+        std::vector<EngineEvent> batch_; // Events collected for the current batch.
+        InstrumentId instrumentId_{ }; // Instrument of the command being applied.
+        std::atomic<bool> snapshotRequested_{ false }; // Set while `snapshotRequests_` is non-empty.
+        std::mutex snapshotMutex_; // Guards `snapshotRequests_`.
+        std::vector<std::promise<std::vector<BookSnapshot>>> snapshotRequests_; // Snapshots to capture between batches.
+        std::thread thread_; // Shard worker thread.
+    };
+
+    OrderbookManagerConfig config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> running_{ false }; // Set while shard threads should keep polling.
+
+    Shard& ShardFor(InstrumentId instrumentId); // Routes an instrument to its shard.
+    void RunShard(std::size_t index); // Shard thread main loop.
+    void ApplyCommand(Shard& shard, const Command& command); // Applies one command on the shard thread.
+    void AdvanceShard(Shard& shard, Timestamp now); // Moves the shard to `now`, advancing only the books due by then.
+    static void Reschedule(Shard& shard, ShardBook& book); // Moves a book within the schedule after its deadline may have changed.
+    static void CatchUpShard(Shard& shard); // Brings every book on a shard to the shard's time.
+    static std::vector<BookSnapshot> CaptureShard(const Shard& shard); // Copies every book on a shard.
+    static void ServeSnapshots(Shard& shard); // Captures the shard for every pending snapshot request.
+
+public:
+    explicit OrderbookManager(OrderbookManagerConfig config);
+    OrderbookManager(const OrderbookManager&) = delete;
+    void operator=(const OrderbookManager&) = delete;
+    OrderbookManager(OrderbookManager&&) = delete;
+    void operator=(OrderbookManager&&) = delete;
+    ~OrderbookManager(); // Stops the shards after they drain already-submitted commands.
+
+    // Registers an instrument; only valid before `Start`. Returns false for duplicates.
+    // A config without its own `memory_` gets the shard's memory, if it has one; the book object is placed there too.
+    bool AddInstrument(InstrumentId instrumentId, OrderbookConfig config = { });
+    void Start(); // Starts the shard threads.
+    void Stop(); // Drains every shard and joins all threads.
+
+    bool Submit(const Command& command); // Any thread: routes by `instrumentId_`; false if that shard's ring is full.
+    std::size_t Submit(std::span<const Command> commands); // Any thread: enqueues in order until a ring fills; returns how many were taken.
+    void Broadcast(const Command& command); // Any thread: delivers a sweep or `AdvanceTime` to every shard, waiting for ring space.
+    std::vector<BookSnapshot> Snapshot(); // Any thread: copies every book, each shard between two batches, without stopping the others.
+    void Restore(const SnapshotReader& snapshot); // Before `Start`: rebuilds registered books, one thread per shard; throws on unknown instruments.
+    std::size_t ShardCount() const { return shards_.size(); }
+    std::size_t ShardOf(InstrumentId instrumentId) const { return instrumentId % shards_.size(); }
+};
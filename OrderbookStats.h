@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "LatencyHistogram.h"
+
+// Build with -DORDERBOOK_STATS=0 to compile every counter and timer out of the book; `GetStats` then returns zeros.
+#ifndef ORDERBOOK_STATS
+#define ORDERBOOK_STATS 1
+#endif
+
+// A point-in-time copy of a book's instrumentation, as returned by `Orderbook::GetStats`. Latencies are in nanoseconds.
+struct OrderbookStats
+{
+    std::uint64_t ordersAdded_{ };    // Add requests, including rejected ones and the re-add half of a cancel/replace.
+    std::uint64_t ordersModified_{ }; // Modify requests for orders that were resting.
+    std::uint64_t ordersRemoved_{ };  // Orders cancelled, expired or replaced; fills are counted in `trades_`.
+    std::uint64_t ordersRejected_{ }; // Adds, cancels and modifies reported through `ExecutionSink::OnReject`.
+    std::uint64_t trades_{ };         // Fills produced by matching.
+    std::size_t bidLevels_{ };        // Non-empty bid levels after the latest mutation.
+    std::size_t askLevels_{ };        // Non-empty ask levels after the latest mutation.
+    std::size_t restingOrders_{ };    // Orders in the book after the latest mutation.
+    double orderIndexLoadFactor_{ };  // Occupied share of the order ID table's slots.
+    // The histograms are empty unless the book was built with `OrderbookConfig::latencyHistograms_`.
+    LatencyHistogram lockWait_;       // Time spent waiting for the orders mutex, zero when uncontended; empty for a single-writer book.
+    LatencyHistogram addOrder_;       // Each add, including its matching.
+    LatencyHistogram matchOrders_;    // Each sweep by an order that crossed the book.
+    LatencyHistogram cancelOrder_;    // Each order removal, whether cancelled, expired or replaced.
+    LatencyHistogram sessionSweep_;   // Each "Good-For-Day" sweep at a session close.
+    LatencyHistogram matchDepth_;     // Fills per order that traded on arrival.
+};
+
+// Timers an `OrderbookInstrumentation` keeps.
+enum class OrderbookTimer
+{
+    LockWait,
+    AddOrder,
+    MatchOrders,
+    CancelOrder,
+    SessionSweep,
+};
+
+// Counters an `OrderbookInstrumentation` keeps.
+enum class OrderbookCounter
+{
+    OrdersAdded,
+    OrdersModified,
+    OrdersRemoved,
+    OrdersRejected,
+    Trades,
+};
+
+#if ORDERBOOK_STATS
+
+// The book's live instrumentation. A book has exactly one writer at a time (its owning thread, or whoever holds
+// its mutex), so every counter is that writer's own and is bumped with relaxed stores; a monitoring thread reads
+// them through `Snapshot` without taking the lock or disturbing the matching thread.
+// The counters are a few words and always kept. The histograms take about 55 KB, mostly cold, so only a book that
+// asks for them carries them; without them, timed scopes do not read the clock.
+class OrderbookInstrumentation
+{
+private:
+    using Clock = std::chrono::steady_clock;
+    using Counter = std::atomic<std::uint64_t>;
+
+    static constexpr std::size_t TimerCount = 5;
+    static constexpr std::size_t CounterCount = 5;
+
+    struct Histograms
+    {
+        LatencyRecorder timers_[TimerCount];
+        LatencyRecorder matchDepth_;
+    };
+
+    std::pmr::memory_resource* memory_; // Where the histograms live, next to the rest of the book.
+    Histograms* histograms_; // Null unless histograms were asked for.
+    Counter counters_[CounterCount]{ };
+    Counter bidLevels_{ 0 };
+    Counter askLevels_{ 0 };
+    Counter restingOrders_{ 0 };
+    Counter orderSlots_{ 0 };
+
+    static void Store(Counter& counter, std::uint64_t value) { counter.store(value, std::memory_order_relaxed); }
+    static std::uint64_t Load(const Counter& counter) { return counter.load(std::memory_order_relaxed); }
+
+public:
+    explicit OrderbookInstrumentation(bool histograms = false, std::pmr::memory_resource* memory = std::pmr::new_delete_resource())
+        : memory_{ memory }
+        , histograms_{ histograms ? std::pmr::polymorphic_allocator<Histograms>{ memory }.new_object<Histograms>() : nullptr }
+    { }
+    OrderbookInstrumentation(const OrderbookInstrumentation&) = delete;
+    void operator=(const OrderbookInstrumentation&) = delete;
+
+    ~OrderbookInstrumentation()
+    {
+        if (histograms_ != nullptr)
+            std::pmr::polymorphic_allocator<Histograms>{ memory_ }.delete_object(histograms_);
+    }
+
+    // Times the enclosing scope into one of the book's timers, if it keeps them.
+    class Scope
+    {
+    public:
+        Scope(OrderbookInstrumentation& stats, OrderbookTimer timer)
+            : recorder_{ stats.histograms_ != nullptr ? &stats.histograms_->timers_[static_cast<std::size_t>(timer)] : nullptr }
+            , start_{ recorder_ != nullptr ? Clock::now() : Clock::time_point{ } }
+        { }
+        Scope(const Scope&) = delete;
+        void operator=(const Scope&) = delete;
+
+        ~Scope()
+        {
+            if (recorder_ != nullptr)
+                recorder_->Record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count()));
+        }
+
+    private:
+        LatencyRecorder* recorder_;
+        Clock::time_point start_;
+    };
+
+    void Count(OrderbookCounter counter, std::uint64_t amount = 1)
+    {
+        auto& value = counters_[static_cast<std::size_t>(counter)];
+        Store(value, Load(value) + amount);
+    }
+
+    // Records a zero-length interval without reading the clock.
+    void RecordUncontended(OrderbookTimer timer)
+    {
+        if (histograms_ != nullptr)
+            histograms_->timers_[static_cast<std::size_t>(timer)].Record(0);
+    }
+
+    void RecordMatchDepth(std::uint64_t fills)
+    {
+        if (histograms_ != nullptr)
+            histograms_->matchDepth_.Record(fills);
+    }
+
+    // Publishes the book's shape after a mutation.
+    void RecordShape(std::size_t bidLevels, std::size_t askLevels, std::size_t restingOrders, std::size_t orderSlots)
+    {
+        Store(bidLevels_, bidLevels);
+        Store(askLevels_, askLevels);
+        Store(restingOrders_, restingOrders);
+        Store(orderSlots_, orderSlots);
+    }
+
+    OrderbookStats Snapshot() const
+    {
+        OrderbookStats stats;
+        stats.ordersAdded_ = Load(counters_[static_cast<std::size_t>(OrderbookCounter::OrdersAdded)]);
+        stats.ordersModified_ = Load(counters_[static_cast<std::size_t>(OrderbookCounter::OrdersModified)]);
+        stats.ordersRemoved_ = Load(counters_[static_cast<std::size_t>(OrderbookCounter::OrdersRemoved)]);
+        stats.ordersRejected_ = Load(counters_[static_cast<std::size_t>(OrderbookCounter::OrdersRejected)]);
+        stats.trades_ = Load(counters_[static_cast<std::size_t>(OrderbookCounter::Trades)]);
+        stats.bidLevels_ = static_cast<std::size_t>(Load(bidLevels_));
+        stats.askLevels_ = static_cast<std::size_t>(Load(askLevels_));
+        stats.restingOrders_ = static_cast<std::size_t>(Load(restingOrders_));
+
+        const auto slots = Load(orderSlots_);
+        stats.orderIndexLoadFactor_ = slots == 0 ? 0.0 : static_cast<double>(stats.restingOrders_) / static_cast<double>(slots);
+
+        if (histograms_ == nullptr)
+            return stats;
+
+        const auto& timers = histograms_->timers_;
+        stats.lockWait_ = timers[static_cast<std::size_t>(OrderbookTimer::LockWait)].Snapshot();
+        stats.addOrder_ = timers[static_cast<std::size_t>(OrderbookTimer::AddOrder)].Snapshot();
+        stats.matchOrders_ = timers[static_cast<std::size_t>(OrderbookTimer::MatchOrders)].Snapshot();
+        stats.cancelOrder_ = timers[static_cast<std::size_t>(OrderbookTimer::CancelOrder)].Snapshot();
+        stats.sessionSweep_ = timers[static_cast<std::size_t>(OrderbookTimer::SessionSweep)].Snapshot();
+        stats.matchDepth_ = histograms_->matchDepth_.Snapshot();
+        return stats;
+    }
+};
+
+#else
+
+// Instrumentation compiled out: the same interface with no state and no clock reads.
+class OrderbookInstrumentation
+{
+public:
+    explicit OrderbookInstrumentation(bool = false, std::pmr::memory_resource* = nullptr) { }
+
+    class Scope
+    {
+    public:
+        Scope(OrderbookInstrumentation&, OrderbookTimer) { }
+        Scope(const Scope&) = delete;
+        void operator=(const Scope&) = delete;
+    };
+
+    void Count(OrderbookCounter, std::uint64_t = 1) { }
+    void RecordUncontended(OrderbookTimer) { }
+    void RecordMatchDepth(std::uint64_t) { }
+    void RecordShape(std::size_t, std::size_t, std::size_t, std::size_t) { }
+    OrderbookStats Snapshot() const { return { }; }
+};
+
+#endif
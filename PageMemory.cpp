@@ -0,0 +1,232 @@
+#include "PageMemory.h"
+#include "Failure.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::size_t TwoMegabytes = std::size_t{ 1 } << 21;
+    constexpr std::size_t OneGigabyte = std::size_t{ 1 } << 30;
+
+    // Small blocks from many structures share a region, and a region never needs more than one 2 MB page
+    constexpr std::size_t RegionSize = TwoMegabytes;
+
+    std::size_t RoundUp(std::size_t value, std::size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    std::size_t RoundDown(std::size_t value, std::size_t multiple)
+    {
+        return value / multiple * multiple;
+    }
+
+    std::size_t BasePageSize()
+    {
+#if defined(_WIN32)
+        SYSTEM_INFO info{ };
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#elif defined(__linux__)
+        return static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+#else
+        return 4096;
+#endif
+    }
+
+    std::size_t HugePageSize([[maybe_unused]] PageSize pageSize)
+    {
+#if defined(_WIN32)
+        // Windows has one large page size
+        const auto large = GetLargePageMinimum();
+        return large != 0 ? large : TwoMegabytes;
+#else
+        return pageSize == PageSize::Huge1GB ? OneGigabyte : TwoMegabytes;
+#endif
+    }
+
+#if defined(__linux__)
+    // Sets a preferred-node policy on a range that has not been touched yet; spills to other nodes rather than failing
+    void PlaceOnNode(void* data, std::size_t size, int node)
+    {
+        unsigned long nodes[16]{ };
+        constexpr auto bitsPerWord = sizeof(unsigned long) * CHAR_BIT;
+        if (node < 0 || static_cast<std::size_t>(node) >= std::size(nodes) * bitsPerWord)
+            return;
+
+        nodes[node / bitsPerWord] = 1UL << (node % bitsPerWord);
+        ::syscall(SYS_mbind, data, size, MPOL_PREFERRED, nodes, std::size(nodes) * bitsPerWord + 1, 0);
+    }
+#endif
+}
+
+// Constructor: picks the granularity of large mappings; nothing is mapped until the first block is asked for
+PageMemory::PageMemory(const PageMemoryConfig& config)
+    : config_{ config }
+    , granularity_{ config.pageSize_ == PageSize::Small ? BasePageSize() : HugePageSize(config.pageSize_) }
+{
+}
+
+// Destructor: returns the carving regions to the OS
+PageMemory::~PageMemory()
+{
+    while (regions_ != nullptr)
+    {
+        const Mapping region{ regions_, regions_->size_, 0 };
+        regions_ = regions_->previous_;
+        Unmap(region);
+    }
+}
+
+// Function to start carving from a fresh region, which records itself in its first bytes
+void PageMemory::AddRegion()
+{
+    // Regions use 2 MB pages even when large blocks get 1 GB ones
+    const auto mapping = Map(RegionSize, config_.pageSize_ == PageSize::Huge1GB ? PageSize::Huge2MB : config_.pageSize_);
+    regions_ = ::new (mapping.data_) Region{ regions_, mapping.size_ };
+    cursor_ = static_cast<std::byte*>(mapping.data_) + sizeof(Region);
+    end_ = static_cast<std::byte*>(mapping.data_) + mapping.size_;
+
+    // Writing the header has already faulted in the first page
+    faulted_ = static_cast<std::byte*>(mapping.data_) + mapping.pageSize_;
+    regionPageSize_ = mapping.pageSize_;
+}
+
+// Function to fault in a range of pages ahead of use. A write, not a read, so each page gets its own frame rather than
+// the shared zero page; only the first byte of each page is written, so callers pass pages nothing else is using yet
+void PageMemory::Touch(std::byte* begin, std::byte* end, std::size_t pageSize)
+{
+    auto page = reinterpret_cast<std::byte*>(RoundDown(reinterpret_cast<std::uintptr_t>(begin), pageSize));
+    for (; page < end; page += pageSize)
+        *static_cast<volatile std::byte*>(page) = std::byte{ 0 };
+}
+
+// Function to map whole pages and place them
+PageMemory::Mapping PageMemory::Map(std::size_t bytes, PageSize requested)
+{
+    [[maybe_unused]] const bool huge = requested != PageSize::Small;
+    std::size_t pageSize = huge ? HugePageSize(requested) : BasePageSize();
+    const auto size = RoundUp(bytes, pageSize);
+    void* data = nullptr;
+
+#if defined(_WIN32)
+    const DWORD node = config_.numaNode_ >= 0 ? static_cast<DWORD>(config_.numaNode_) : NUMA_NO_PREFERRED_NODE;
+    if (huge)
+        data = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+
+    // Large pages need the lock-memory privilege; without it the same range comes from base pages
+    if (data == nullptr)
+    {
+        data = VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+        if (data == nullptr)
+            Raise(std::bad_alloc{ });
+
+        if (huge)
+        {
+            ++hugePageFallbacks_;
+            pageSize = BasePageSize();
+        }
+    }
+#elif defined(__linux__)
+    if (huge)
+    {
+        const int hugeFlags = MAP_HUGETLB | ((requested == PageSize::Huge1GB ? 30 : 21) << MAP_HUGE_SHIFT);
+        data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | hugeFlags, -1, 0);
+        if (data == MAP_FAILED)
+            data = nullptr;
+    }
+
+    // Without reserved huge pages, ask for transparent ones over base pages instead
+    if (data == nullptr)
+    {
+        data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+            Raise(std::bad_alloc{ });
+
+        if (huge)
+        {
+            ::madvise(data, size, MADV_HUGEPAGE);
+            ++hugePageFallbacks_;
+            pageSize = BasePageSize();
+        }
+    }
+
+    // The policy has to be set before the first touch, which is what places a page
+    if (config_.numaNode_ >= 0)
+        PlaceOnNode(data, size, config_.numaNode_);
+#else
+    pageSize = BasePageSize();
+    data = ::operator new(size, std::align_val_t{ pageSize });
+#endif
+
+    mappedBytes_ += size;
+    return Mapping{ data, size, pageSize };
+}
+
+// Function to give a mapping back to the OS
+void PageMemory::Unmap(const Mapping& mapping)
+{
+#if defined(_WIN32)
+    VirtualFree(mapping.data_, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    ::munmap(mapping.data_, mapping.size_);
+#else
+    ::operator delete(mapping.data_, std::align_val_t{ BasePageSize() });
+#endif
+
+    mappedBytes_ -= mapping.size_;
+}
+
+// Function to hand out a block: large ones are mapped on their own, small ones carved from the newest region
+void* PageMemory::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    // Mappings start on a page boundary, which covers any alignment short of one
+    if (bytes > RegionSize / 8)
+    {
+        if (alignment > BasePageSize())
+            Raise(std::bad_alloc{ });
+
+        // Only the bytes asked for are faulted in, not the rest of a huge page or a fallback's rounding
+        const auto mapping = Map(bytes, config_.pageSize_);
+        if (config_.prefault_)
+            Touch(static_cast<std::byte*>(mapping.data_), static_cast<std::byte*>(mapping.data_) + bytes, mapping.pageSize_);
+        return mapping.data_;
+    }
+
+    auto block = RoundUp(reinterpret_cast<std::uintptr_t>(cursor_), alignment);
+    if (cursor_ == nullptr || block + bytes > reinterpret_cast<std::uintptr_t>(end_))
+    {
+        AddRegion();
+        block = RoundUp(reinterpret_cast<std::uintptr_t>(cursor_), alignment);
+    }
+
+    cursor_ = reinterpret_cast<std::byte*>(block + bytes);
+
+    // Pages at or past `faulted_` hold nothing handed out yet, so touching them cannot disturb a live block
+    if (config_.prefault_ && cursor_ > faulted_)
+    {
+        Touch(faulted_, cursor_, regionPageSize_);
+        faulted_ = reinterpret_cast<std::byte*>(RoundUp(reinterpret_cast<std::uintptr_t>(cursor_), regionPageSize_));
+    }
+
+    return reinterpret_cast<void*>(block);
+}
+
+// Function to take a block back; only large blocks are unmapped here, carved ones return with their region
+void PageMemory::do_deallocate(void* memory, std::size_t bytes, std::size_t)
+{
+    if (bytes > RegionSize / 8)
+        Unmap(Mapping{ memory, RoundUp(bytes, granularity_), 0 });
+}
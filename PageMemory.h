@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+// Size of the pages behind a `PageMemory`.
+enum class PageSize
+{
+    Small,   // The platform's base pages, usually 4 KB.
+    Huge2MB, // 2 MB huge pages from the reserved pool; without reserved pages, base pages marked for transparent huge pages.
+    Huge1GB, // 1 GB huge pages from the reserved pool, falling back the same way.
+};
+
+// Where and how a `PageMemory` maps its pages.
+struct PageMemoryConfig
+{
+    PageSize pageSize_{ PageSize::Small };
+    int numaNode_{ -1 };     // NUMA node the pages are placed on; -1 leaves placement to the OS.
+    bool prefault_{ false }; // Touch every page a block spans as it is handed out, so first use takes no page faults.
+};
+
+// A memory resource that maps pages straight from the OS, optionally huge, placed on one NUMA node and pre-faulted.
+// Large blocks (pool slabs, ID tables, ladders) get mappings of their own, which go back to the OS when freed.
+// Small blocks are carved from shared 2 MB regions and only return with the resource, which suits book objects
+// and the chunk requests of a book's arena; with 1 GB pages the regions still use 2 MB pages, so a shard never
+// commits a gigabyte for a few small blocks. Pre-faulting touches only the pages handed out, not whole mappings.
+// Placement is best effort: a kernel without NUMA support keeps its default policy.
+// Not synchronized; like a book's arena, it is used by one thread at a time.
+class PageMemory final : public std::pmr::memory_resource
+{
+private:
+    struct Mapping
+    {
+        void* data_{ nullptr };
+        std::size_t size_{ 0 };
+        std::size_t pageSize_{ 0 }; // Pages the mapping actually got, which are base pages when huge ones ran out.
+    };
+
+    // Leads each carving region and chains it to the one before, so keeping track of regions never allocates.
+    struct Region
+    {
+        Region* previous_{ nullptr };
+        std::size_t size_{ 0 };
+    };
+
+    PageMemoryConfig config_;
+    std::size_t granularity_; // Every large mapping is a multiple of this: the huge page size, or the base page size.
+    Region* regions_{ nullptr }; // Newest region small blocks are carved from.
+    std::byte* cursor_{ nullptr }; // Next free byte of the newest region.
+    std::byte* end_{ nullptr }; // End of the newest region.
+    std::byte* faulted_{ nullptr }; // Pages of the newest region below this have been touched.
+    std::size_t regionPageSize_{ 0 }; // Pages the newest region got.
+    std::size_t mappedBytes_{ 0 };
+    std::size_t hugePageFallbacks_{ 0 };
+
+    Mapping Map(std::size_t bytes, PageSize pageSize); // Maps and places at least `bytes` of `pageSize` pages.
+    void Unmap(const Mapping& mapping);
+    void AddRegion(); // Maps a new carving region and carves from it from now on.
+    static void Touch(std::byte* begin, std::byte* end, std::size_t pageSize); // Faults in the pages from `begin`, page-aligned, up to `end`.
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+public:
+    explicit PageMemory(const PageMemoryConfig& config);
+    PageMemory(const PageMemory&) = delete;
+    void operator=(const PageMemory&) = delete;
+    ~PageMemory() override; // Unmaps the carving regions; owners must have freed their large blocks.
+
+    const PageMemoryConfig& GetConfig() const { return config_; }
+    std::size_t MappedBytes() const { return mappedBytes_; } // Bytes currently mapped, carving regions included.
+    std::size_t HugePageFallbacks() const { return hugePageFallbacks_; } // Mappings that asked for huge pages and got base pages.
+};
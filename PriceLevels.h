@@ -0,0 +1,285 @@
+#pragma once
+
+#include <map>
+#include <memory_resource>
+#include <vector>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Usings.h"
+#include "Side.h"
+#include "OrderQueue.h"
+#include "OrderbookConfig.h"
+#include "Failure.h"
+
+// A price level: its FIFO of resting orders plus the aggregates kept right next to it,
+// so matching and depth queries read the totals from memory the queue access already touched.
+struct PriceLevel
+{
+    OrderQueue orders_;    // Orders resting at this price in time priority.
+    Quantity quantity_{ }; // Total remaining quantity at this level.
+    Quantity count_{ };    // Number of orders at this level.
+};
+
+// The price levels for one side of the book, ordered from the best price to the worst.
+// Depending on `OrderbookConfig::levelStorage_` the levels are held either in a `std::map`
+// or in a ladder: a contiguous array indexed by tick, a bitmap of non-empty levels and a cached best index.
+// Ladder indices are laid out so that index 0 is always the most aggressive price for this side,
+// which lets bids and asks share the same "lowest set bit wins" search.
+// Map nodes and columnar queue arrays come from the book's arena, so levels that come and go in steady state
+// recycle its memory instead of calling the global allocator.
+template<Side S>
+class PriceLevels
+{
+private:
+    using Compare = std::conditional_t<S == Side::Buy, std::greater<Price>, std::less<Price>>;
+    using Map = std::pmr::map<Price, PriceLevel, Compare>;
+    using Word = std::uint64_t;
+
+    static constexpr std::size_t WordBits = 64;
+
+public:
+    // Iterates the non-empty levels in price priority, yielding `(price, level)` pairs.
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<Price, const PriceLevel&>;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        value_type operator*() const
+        {
+            if (levels_->ladder_)
+                return { levels_->ToPrice(index_), levels_->ladderLevels_[index_] };
+            return { position_->first, position_->second };
+        }
+
+        Iterator& operator++()
+        {
+            if (levels_->ladder_)
+                index_ = levels_->NextSet(index_ + 1);
+            else
+                ++position_;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return levels_->ladder_ ? index_ == other.index_ : position_ == other.position_;
+        }
+
+    private:
+        friend class PriceLevels;
+
+        Iterator(const PriceLevels* levels, typename Map::const_iterator position, std::size_t index)
+            : levels_{ levels }
+            , position_{ position }
+            , index_{ index }
+        { }
+
+        const PriceLevels* levels_{ nullptr };
+        typename Map::const_iterator position_{ };
+        std::size_t index_{ 0 };
+    };
+
+    PriceLevels(const OrderbookConfig& config, RestingOrderPool& pool, std::pmr::memory_resource* arena)
+        : ladder_{ config.levelStorage_ == LevelStorage::Ladder }
+        , orderLayout_{ config.orderLayout_ }
+        , pool_{ pool }
+        , arena_{ arena }
+        , map_{ arena }
+        , ladderLevels_{ arena }
+        , occupied_{ arena }
+    {
+        if (!ladder_)
+            return;
+
+        if (config.tickSize_ <= 0 || config.levelCount_ == 0)
+            Raise(std::invalid_argument("Ladder price levels need a positive tick size and level count."));
+
+        basePrice_ = config.basePrice_;
+        tickSize_ = config.tickSize_;
+        levelCount_ = config.levelCount_;
+        bestIndex_ = levelCount_;
+
+        // Each level is built in place rather than copied, since a copied queue would lose the arena
+        ladderLevels_.reserve(levelCount_);
+        for (std::size_t i = 0; i < levelCount_; ++i)
+            ladderLevels_.push_back(PriceLevel{ OrderQueue{ orderLayout_, pool_, arena_ } });
+        occupied_.resize((levelCount_ + WordBits - 1) / WordBits);
+    }
+
+    bool Empty() const { return Size() == 0; }
+
+    // Number of non-empty price levels.
+    std::size_t Size() const { return ladder_ ? ladderSize_ : map_.size(); }
+
+    // Whether an order at this price can be stored; ladders only hold on-tick prices inside the band.
+    bool Accepts(Price price) const
+    {
+        if (!ladder_)
+            return true;
+
+        if (price < basePrice_ || (price - basePrice_) % tickSize_ != 0)
+            return false;
+
+        return static_cast<std::size_t>((price - basePrice_) / tickSize_) < levelCount_;
+    }
+
+    // Total remaining quantity over every level, so a sweep that cannot fill is rejected without walking the side.
+    std::uint64_t TotalQuantity() const { return totalQuantity_; }
+
+    // Keep `TotalQuantity` in step with the level aggregates.
+    void AddQuantity(Quantity quantity) { totalQuantity_ += quantity; }
+    void RemoveQuantity(Quantity quantity) { totalQuantity_ -= quantity; }
+
+    // The most aggressive price with resting orders. The side must not be empty.
+    Price BestPrice() const { return ladder_ ? ToPrice(bestIndex_) : map_.begin()->first; }
+
+    // The least aggressive price with resting orders. The side must not be empty.
+    Price WorstPrice() const { return ladder_ ? ToPrice(PrevSet(levelCount_)) : map_.rbegin()->first; }
+
+    // The level at the best price. The side must not be empty.
+    PriceLevel& Best() { return ladder_ ? ladderLevels_[bestIndex_] : map_.begin()->second; }
+
+    // An existing level.
+    PriceLevel& At(Price price) { return ladder_ ? ladderLevels_[ToIndex(price)] : map_.at(price); }
+
+    // The level at a price, marking it as occupied if it was empty.
+    PriceLevel& GetOrAdd(Price price)
+    {
+        if (!ladder_)
+        {
+            auto position = map_.find(price);
+            if (position == map_.end())
+                position = map_.emplace(price, PriceLevel{ OrderQueue{ orderLayout_, pool_, arena_ } }).first;
+            return position->second;
+        }
+
+        const auto index = ToIndex(price);
+        auto& word = occupied_[index / WordBits];
+        const Word bit = Word{ 1 } << (index % WordBits);
+
+        if ((word & bit) == 0)
+        {
+            word |= bit;
+            ++ladderSize_;
+            if (index < bestIndex_)
+                bestIndex_ = index;
+        }
+
+        return ladderLevels_[index];
+    }
+
+    // Removes a level whose orders have all left.
+    void Erase(Price price)
+    {
+        if (!ladder_)
+        {
+            map_.erase(price);
+            return;
+        }
+
+        const auto index = ToIndex(price);
+        occupied_[index / WordBits] &= ~(Word{ 1 } << (index % WordBits));
+        --ladderSize_;
+
+        if (index == bestIndex_)
+            bestIndex_ = NextSet(index + 1);
+    }
+
+    Iterator begin() const { return Iterator{ this, map_.begin(), bestIndex_ }; }
+    Iterator end() const { return Iterator{ this, map_.end(), levelCount_ }; }
+
+    // Bytes held by the levels and their queues; map nodes are counted at their payload plus the tree's own links.
+    std::size_t MemoryUsage() const
+    {
+        constexpr std::size_t TreeLinks = 4 * sizeof(void*);
+
+        std::size_t bytes = map_.size() * (sizeof(typename Map::value_type) + TreeLinks)
+            + ladderLevels_.capacity() * sizeof(PriceLevel) + occupied_.capacity() * sizeof(Word);
+
+        for (const auto& [price, level] : map_)
+            bytes += level.orders_.MemoryUsage();
+        for (const auto& level : ladderLevels_)
+            bytes += level.orders_.MemoryUsage();
+
+        return bytes;
+    }
+
+private:
+    std::size_t ToIndex(Price price) const
+    {
+        const auto tick = static_cast<std::size_t>((price - basePrice_) / tickSize_);
+        return S == Side::Buy ? levelCount_ - 1 - tick : tick;
+    }
+
+    Price ToPrice(std::size_t index) const
+    {
+        const auto tick = S == Side::Buy ? levelCount_ - 1 - index : index;
+        return basePrice_ + static_cast<Price>(tick) * tickSize_;
+    }
+
+    // First occupied index at or after `from`, or `levelCount_` if there is none.
+    std::size_t NextSet(std::size_t from) const
+    {
+        if (from >= levelCount_)
+            return levelCount_;
+
+        auto wordIndex = from / WordBits;
+        Word word = occupied_[wordIndex] & (~Word{ 0 } << (from % WordBits));
+
+        while (word == 0)
+        {
+            if (++wordIndex == occupied_.size())
+                return levelCount_;
+            word = occupied_[wordIndex];
+        }
+
+        return wordIndex * WordBits + std::countr_zero(word);
+    }
+
+    // Last occupied index before `before`, or `levelCount_` if there is none.
+    std::size_t PrevSet(std::size_t before) const
+    {
+        if (before == 0)
+            return levelCount_;
+
+        const auto last = before - 1;
+        auto wordIndex = last / WordBits;
+        const auto shift = WordBits - 1 - last % WordBits;
+        Word word = occupied_[wordIndex] & (~Word{ 0 } >> shift);
+
+        while (word == 0)
+        {
+            if (wordIndex == 0)
+                return levelCount_;
+            word = occupied_[--wordIndex];
+        }
+
+        return wordIndex * WordBits + (WordBits - 1 - std::countl_zero(word));
+    }
+
+    bool ladder_;
+    OrderLayout orderLayout_;
+    RestingOrderPool& pool_; // Where the orders of every level live.
+    std::pmr::memory_resource* arena_; // Where map nodes, queue arrays and the ladder are allocated.
+    Map map_;
+    std::uint64_t totalQuantity_{ 0 };
+
+    Price basePrice_{ 0 };
+    Price tickSize_{ 1 };
+    std::size_t levelCount_{ 0 };
+    std::size_t bestIndex_{ 0 };
+    std::size_t ladderSize_{ 0 };
+    std::pmr::vector<PriceLevel> ladderLevels_;
+    std::pmr::vector<Word> occupied_;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// Why an order book turned a request away. Rejects are ordinary, frequent events in live flow, so the book reports
+// them as a one-byte code through `ExecutionSink::OnReject`; turning one into text is left to whoever logs it.
+enum class RejectReason : std::uint8_t
+{
+    DuplicateOrderId, // An add reused the ID of an order that is still resting.
+    UnknownOrder,     // A cancel or modify named an order that is not resting.
+    NoLiquidity,      // A market or "Fill-And-Kill" order found nothing to trade against.
+    CannotFullyFill,  // A "Fill-Or-Kill" order could not be filled completely.
+    PriceOutOfBand,   // The price is outside the ladder's band or off its tick.
+    Expired,          // A "Good-Till-Date" order arrived at or after its deadline.
+    WrongOrderType,   // A typed `AddOrder<Type>` was given an order of another type.
+    UnknownInstrument, // A sharded engine got a command for an instrument no book was registered for.
+    InvalidQuantity,  // An add asked for zero quantity; a modify to zero cancels the order and reports this for its replacement.
+};
+
+// Text for logs; never called by the book itself.
+constexpr const char* ToString(RejectReason reason)
+{
+    switch (reason)
+    {
+    case RejectReason::DuplicateOrderId: return "duplicate order ID";
+    case RejectReason::UnknownOrder: return "unknown order";
+    case RejectReason::NoLiquidity: return "no liquidity";
+    case RejectReason::CannotFullyFill: return "cannot fully fill";
+    case RejectReason::PriceOutOfBand: return "price out of band";
+    case RejectReason::Expired: return "expired";
+    case RejectReason::WrongOrderType: return "wrong order type";
+    case RejectReason::UnknownInstrument: return "unknown instrument";
+    case RejectReason::InvalidQuantity: return "invalid quantity";
+    }
+
+    return "unknown reject";
+}
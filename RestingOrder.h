@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+
+#include "Usings.h"
+#include "Order.h"
+#include "ObjectPool.h"
+#include "Failure.h"
+
+// Names a resting order in the book's pool.
+using OrderHandle = PoolIndex;
+
+// The handle no resting order ever has.
+inline constexpr OrderHandle NoOrder = NoPoolIndex;
+
+// The hidden part of a resting iceberg order. Only icebergs have one, so it lives in a pool of its own
+// rather than widening every resting order.
+struct OrderReserve
+{
+    Quantity displayQuantity_{ }; // Size of each slice shown.
+    Quantity hiddenQuantity_{ };  // Still to be shown once the current slice fills.
+};
+
+// Names an iceberg's reserve in the book's pool.
+using ReserveHandle = PoolIndex;
+
+// The handle of an order that shows everything.
+inline constexpr ReserveHandle NoReserve = NoPoolIndex;
+
+// The book's own record of an order while it rests. Only what matching, cancelling and snapshots need is kept:
+// the order type and side share one byte, queue links are pool indices rather than pointers, and a "Good-Till-Date"
+// deadline lives only in the expiry index. With the standard widths the whole record is 32 bytes.
+// An iceberg order's remaining quantity is only its shown slice; the rest is in its `OrderReserve`.
+class RestingOrder
+{
+public:
+    explicit RestingOrder(const Order& order)
+        : RestingOrder(order, order.GetRemainingQuantity())
+    { }
+
+    // Rests `order` showing only `shown` of its remaining quantity; anything less than all of it makes an iceberg.
+    RestingOrder(const Order& order, Quantity shown)
+        : orderId_{ order.GetOrderId() }
+        , price_{ order.GetPrice() }
+        , initialQuantity_{ order.GetInitialQuantity() }
+        , remainingQuantity_{ shown }
+        , typeAndSide_{ static_cast<std::uint8_t>(static_cast<std::uint8_t>(order.GetOrderType()) | (order.GetSide() == Side::Sell ? SellBit : 0)
+            | (shown < order.GetRemainingQuantity() ? IcebergBit : 0)) }
+    { }
+
+    OrderId GetOrderId() const { return orderId_; }
+    Side GetSide() const { return (typeAndSide_ & SellBit) != 0 ? Side::Sell : Side::Buy; }
+    Price GetPrice() const { return price_; }
+    OrderType GetOrderType() const { return static_cast<OrderType>(typeAndSide_ & TypeMask); }
+    Quantity GetInitialQuantity() const { return initialQuantity_; }
+    Quantity GetRemainingQuantity() const { return remainingQuantity_; }
+    bool IsFilled() const { return GetRemainingQuantity() == 0; }
+    bool IsIceberg() const { return (typeAndSide_ & IcebergBit) != 0; } // Whether the order has an `OrderReserve`.
+
+    // Takes a fill off the remaining quantity.
+    void Fill(Quantity quantity)
+    {
+        if (quantity > GetRemainingQuantity())
+            Fail("cannot be filled for more than its remaining quantity");
+
+        remainingQuantity_ -= quantity;
+    }
+
+    // Shrinks the order in place; the cancelled amount leaves both the initial and the remaining quantity.
+    void Reduce(Quantity quantity)
+    {
+        if (quantity > GetRemainingQuantity())
+            Fail("cannot be reduced by more than its remaining quantity");
+
+        initialQuantity_ -= quantity;
+        remainingQuantity_ -= quantity;
+    }
+
+    // Shrinks an iceberg's hidden part, which its reserve tracks; only the initial quantity changes here.
+    void ReduceHidden(Quantity quantity) { initialQuantity_ -= quantity; }
+
+private:
+    // Formats and raises a broken invariant; the book checks quantities before it calls in, so this never runs in normal flow.
+    [[noreturn, gnu::cold, gnu::noinline]] void Fail(const char* what) const
+    {
+        Raise(std::logic_error(std::format("Order ({}) {}.", GetOrderId(), what)));
+    }
+
+    static constexpr std::uint8_t SellBit = 0x80;
+    static constexpr std::uint8_t IcebergBit = 0x40;
+    static constexpr std::uint8_t TypeMask = 0x3F;
+
+    OrderId orderId_;
+    Price price_;
+    Quantity initialQuantity_;
+    Quantity remainingQuantity_;
+
+    // Position in the `OrderQueue` of the order's price level: intrusive links, or a slot in a columnar level.
+    union
+    {
+        OrderHandle prev_{ NoOrder }; // The order ahead of this one in time priority.
+        std::uint32_t slot_;          // Index into the level's columns.
+    };
+    OrderHandle next_{ NoOrder };     // The order behind this one in time priority.
+    std::uint8_t typeAndSide_;        // `OrderType` in the low bits, `SellBit` for the sell side, `IcebergBit` for a reserve.
+
+    friend class OrderQueue;
+};
+
+static_assert(sizeof(RestingOrder) <= 32, "A resting order should fit in half a cache line.");
+
+// The storage every resting order of one book lives in.
+using RestingOrderPool = ObjectPool<RestingOrder>;
+
+// The storage for the reserves of one book's iceberg orders.
+using OrderReservePool = ObjectPool<OrderReserve>;
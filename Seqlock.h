@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// A single-writer sequence lock around a small trivially copyable value.
+// The writer never waits; readers retry if they overlap a write. The payload is held in
+// relaxed atomic words so concurrent reads are well defined rather than a benign data race.
+template<typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock values are copied word by word.");
+
+    using Word = std::uint64_t;
+    static constexpr std::size_t WordCount = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+    using Words = std::array<Word, WordCount>;
+
+public:
+    explicit Seqlock(const T& value = { }) { Store(value); }
+
+    // Writer side: publishes a new value. Only one thread may store at a time.
+    void Store(const T& value)
+    {
+        const auto words = ToWords(value);
+        const auto sequence = sequence_.load(std::memory_order_relaxed);
+
+        sequence_.store(sequence + 1, std::memory_order_relaxed); // Odd: write in progress.
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WordCount; ++i)
+            words_[i].store(words[i], std::memory_order_relaxed);
+
+        sequence_.store(sequence + 2, std::memory_order_release); // Even: stable again.
+    }
+
+    // Reader side, any thread: returns a consistent copy of the latest value without blocking the writer.
+    T Load() const
+    {
+        Words words;
+
+        while (true)
+        {
+            const auto before = sequence_.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            for (std::size_t i = 0; i < WordCount; ++i)
+                words[i] = words_[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        return FromWords(words);
+    }
+
+private:
+    static Words ToWords(const T& value)
+    {
+        Words words{ };
+        std::memcpy(words.data(), &value, sizeof(T));
+        return words;
+    }
+
+    static T FromWords(const Words& words)
+    {
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    std::atomic<std::uint64_t> sequence_{ 0 };
+    std::array<std::atomic<Word>, WordCount> words_{ };
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Usings.h"
+
+// Converts a wall-clock time point to an order book timestamp.
+inline Timestamp ToTimestamp(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Converts an order book timestamp to a wall-clock time point.
+inline std::chrono::system_clock::time_point ToTimePoint(Timestamp timestamp)
+{
+    return std::chrono::system_clock::time_point{ std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{ timestamp }) };
+}
+
+// Source of the current time for an order book or engine.
+class SessionClock
+{
+public:
+    virtual ~SessionClock() = default;
+
+    virtual Timestamp Now() const = 0;
+};
+
+// Wall-clock time.
+class SystemClock final : public SessionClock
+{
+public:
+    Timestamp Now() const override { return ToTimestamp(std::chrono::system_clock::now()); }
+
+    static const SystemClock& Instance()
+    {
+        static const SystemClock clock;
+        return clock;
+    }
+};
+
+// Time that only moves when it is told to, e.g. from the timestamps of replayed events.
+class SimulatedClock final : public SessionClock
+{
+private:
+    std::atomic<Timestamp> now_;
+
+public:
+    explicit SimulatedClock(Timestamp start = 0)
+        : now_{ start }
+    { }
+
+    Timestamp Now() const override { return now_.load(std::memory_order_acquire); }
+
+    void Set(Timestamp now) { now_.store(now, std::memory_order_release); }
+    void Advance(Timestamp nanoseconds) { now_.fetch_add(nanoseconds, std::memory_order_acq_rel); }
+};
+
+// Tells an order book when each trading session closes, which is when "Good-For-Day" orders expire.
+class SessionCalendar
+{
+public:
+    static constexpr Timestamp Never = std::numeric_limits<Timestamp>::max();
+
+    virtual ~SessionCalendar() = default;
+
+    // Returns the first session close strictly after `now`, or `Never`.
+    virtual Timestamp NextClose(Timestamp now) const = 0;
+};
+
+// Closes every day at the same time of day, either in the machine's local time zone or at a fixed UTC offset.
+class DailyCloseCalendar final : public SessionCalendar
+{
+private:
+    std::chrono::minutes closeTime_;
+    std::optional<std::chrono::minutes> utcOffset_;
+
+    static std::tm ToLocalTime(std::time_t time)
+    {
+        std::tm parts{ };
+#if defined(_WIN32)
+        localtime_s(&parts, &time);
+#else
+        localtime_r(&time, &parts);
+#endif
+        return parts;
+    }
+
+public:
+    explicit DailyCloseCalendar(std::chrono::minutes closeTime = std::chrono::hours(16),
+        std::optional<std::chrono::minutes> utcOffset = std::nullopt)
+        : closeTime_{ closeTime }
+        , utcOffset_{ utcOffset }
+    { }
+
+    Timestamp NextClose(Timestamp now) const override
+    {
+        using namespace std::chrono;
+
+        // A fixed offset needs no time zone database, so replays give the same answer on every machine
+        if (utcOffset_)
+        {
+            const auto venueNow = nanoseconds{ now } + *utcOffset_;
+            auto close = floor<days>(venueNow) + closeTime_;
+            if (close <= venueNow)
+                close += days{ 1 };
+
+            return duration_cast<nanoseconds>(close - *utcOffset_).count();
+        }
+
+        const auto now_c = system_clock::to_time_t(time_point_cast<system_clock::duration>(ToTimePoint(now)));
+        std::tm parts = ToLocalTime(now_c);
+        const auto secondsOfDay = parts.tm_hour * 3600 + parts.tm_min * 60 + parts.tm_sec;
+
+        // If the current time is at or after the close, move to the next day
+        if (secondsOfDay >= duration_cast<seconds>(closeTime_).count())
+            parts.tm_mday += 1;
+
+        parts.tm_hour = static_cast<int>(duration_cast<hours>(closeTime_).count());
+        parts.tm_min = static_cast<int>((closeTime_ % hours(1)).count());
+        parts.tm_sec = 0;
+        parts.tm_isdst = -1;
+
+        return ToTimestamp(system_clock::from_time_t(std::mktime(&parts)));
+    }
+
+    // 4 PM in the local time zone.
+    static const DailyCloseCalendar& Default()
+    {
+        static const DailyCloseCalendar calendar;
+        return calendar;
+    }
+};
+
+// An explicit list of session closes, for venues with holidays and half days.
+class ExchangeCalendar final : public SessionCalendar
+{
+private:
+    std::vector<Timestamp> closes_; // Sorted ascending.
+
+public:
+    explicit ExchangeCalendar(std::vector<Timestamp> closes)
+        : closes_{ std::move(closes) }
+    {
+        std::sort(closes_.begin(), closes_.end());
+    }
+
+    Timestamp NextClose(Timestamp now) const override
+    {
+        const auto close = std::upper_bound(closes_.begin(), closes_.end(), now);
+        return close == closes_.end() ? Never : *close;
+    }
+};
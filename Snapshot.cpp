@@ -0,0 +1,121 @@
+#include "Snapshot.h"
+#include "Failure.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Forces a written file's contents to disk
+    bool SyncFile(std::FILE* file)
+    {
+        if (std::fflush(file) != 0)
+            return false;
+#if defined(_WIN32)
+        return _commit(_fileno(file)) == 0;
+#elif defined(__linux__)
+        return ::fdatasync(::fileno(file)) == 0;
+#else
+        return ::fsync(::fileno(file)) == 0;
+#endif
+    }
+
+    // Forces a directory's entries to disk, so a rename into it survives power loss
+    bool SyncDirectory([[maybe_unused]] const std::filesystem::path& directory)
+    {
+#if defined(_WIN32)
+        // NTFS journals the rename itself; Windows has no way to sync a directory handle
+        return true;
+#else
+        const int descriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (descriptor < 0)
+            return false;
+
+        const bool synced = ::fsync(descriptor) == 0;
+        ::close(descriptor);
+        return synced;
+#endif
+    }
+}
+
+// Function to write a snapshot file: header, book directory, then every book's orders back to back
+void WriteSnapshot(const std::string& path, std::span<const BookSnapshot> books)
+{
+    const auto temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr)
+        Raise(std::runtime_error("Snapshot (" + temporary + ") could not be opened for writing"));
+
+    SnapshotHeader header;
+    header.bookCount_ = static_cast<std::uint32_t>(books.size());
+
+    std::vector<SnapshotBookHeader> directory;
+    directory.reserve(books.size());
+
+    auto offset = sizeof(SnapshotHeader) + books.size() * sizeof(SnapshotBookHeader);
+    for (const auto& book : books)
+    {
+        directory.push_back(SnapshotBookHeader{ book.instrumentId_, 0, book.journalSequence_, book.time_, book.orders_.size(), offset });
+        offset += book.orders_.size() * sizeof(SnapshotOrder);
+    }
+
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && (directory.empty() || std::fwrite(directory.data(), sizeof(SnapshotBookHeader), directory.size(), file) == directory.size());
+    for (const auto& book : books)
+        written = written && (book.orders_.empty()
+            || std::fwrite(book.orders_.data(), sizeof(SnapshotOrder), book.orders_.size(), file) == book.orders_.size());
+
+    // The data has to be on disk before the rename is, or power loss could leave an empty or torn file under the real name
+    written = written && SyncFile(file);
+    written = std::fclose(file) == 0 && written;
+    if (!written)
+        Raise(std::runtime_error("Snapshot (" + temporary + ") write failed"));
+
+    std::filesystem::rename(temporary, path);
+
+    // Only a synced directory makes the rename itself durable
+    if (!SyncDirectory(std::filesystem::path{ path }.parent_path()))
+        Raise(std::runtime_error("Snapshot (" + path + ") directory sync failed"));
+}
+
+// Constructor: maps the file and checks that every book's orders lie inside it
+SnapshotReader::SnapshotReader(const std::string& path)
+    : file_{ path }
+{
+    const auto bytes = file_.Bytes();
+
+    SnapshotHeader header;
+    if (bytes.size() < sizeof(header))
+        Raise(std::runtime_error("Snapshot (" + path + ") is truncated"));
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic_ != SnapshotHeader::CurrentMagic || header.version_ != SnapshotHeader::CurrentVersion)
+        Raise(std::runtime_error("Snapshot (" + path + ") has an unrecognised header"));
+
+    if (bytes.size() < sizeof(header) + std::size_t{ header.bookCount_ } * sizeof(SnapshotBookHeader))
+        Raise(std::runtime_error("Snapshot (" + path + ") is truncated"));
+
+    books_.reserve(header.bookCount_);
+    for (std::uint32_t i = 0; i < header.bookCount_; ++i)
+    {
+        SnapshotBookHeader book;
+        std::memcpy(&book, bytes.data() + sizeof(header) + i * sizeof(SnapshotBookHeader), sizeof(book));
+
+        if (book.ordersOffset_ % alignof(SnapshotOrder) != 0 || book.ordersOffset_ > bytes.size()
+            || book.orderCount_ > (bytes.size() - book.ordersOffset_) / sizeof(SnapshotOrder))
+            Raise(std::runtime_error("Snapshot (" + path + ") has a book outside the file"));
+
+        const auto orders = reinterpret_cast<const SnapshotOrder*>(bytes.data() + book.ordersOffset_);
+        books_.push_back(SnapshotBookView{ book.instrumentId_, book.journalSequence_, book.time_,
+            std::span{ orders, static_cast<std::size_t>(book.orderCount_) } });
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Usings.h"
+#include "MappedFile.h"
+
+// Snapshots are written and mapped as-is, so the host byte order must match the file's.
+static_assert(std::endian::native == std::endian::little, "Snapshot files are little-endian");
+
+// One resting order in a snapshot.
+struct SnapshotOrder
+{
+    std::uint64_t orderId_{ };
+    std::int64_t expiry_{ };          // "Good-Till-Date" deadline, or 0.
+    std::int32_t price_{ };
+    std::uint32_t initialQuantity_{ };
+    std::uint32_t remainingQuantity_{ }; // Shown and reserve together.
+    std::uint8_t orderType_{ };
+    std::uint8_t side_{ };
+    std::uint8_t reserved_[2]{ };
+    std::uint32_t displayQuantity_{ };   // Iceberg slice size, or 0.
+    std::uint32_t shownQuantity_{ };     // What the level queue shows of `remainingQuantity_`.
+};
+
+static_assert(sizeof(SnapshotOrder) == 40 && std::is_trivially_copyable_v<SnapshotOrder>);
+
+// Leading bytes of every snapshot file, followed by one `SnapshotBookHeader` per book and then the orders.
+struct SnapshotHeader
+{
+    static constexpr std::uint64_t CurrentMagic = 0x313050414E53424FULL; // "OBSNAP01" read little-endian.
+    static constexpr std::uint32_t CurrentVersion = 2; // Version 2 added iceberg quantities to `SnapshotOrder`.
+
+    std::uint64_t magic_{ CurrentMagic };
+    std::uint32_t version_{ CurrentVersion };
+    std::uint32_t bookCount_{ };
+};
+
+static_assert(sizeof(SnapshotHeader) == 16 && std::is_trivially_copyable_v<SnapshotHeader>);
+
+// Directory entry locating one book's orders inside the file.
+struct SnapshotBookHeader
+{
+    std::uint32_t instrumentId_{ };
+    std::uint32_t reserved_{ };
+    std::uint64_t journalSequence_{ }; // Journal records already reflected in this book.
+    std::int64_t time_{ };             // Time the book had been advanced to.
+    std::uint64_t orderCount_{ };
+    std::uint64_t ordersOffset_{ };    // Byte offset of the first order from the start of the file.
+};
+
+static_assert(sizeof(SnapshotBookHeader) == 40 && std::is_trivially_copyable_v<SnapshotBookHeader>);
+
+// A captured book: bids best to worst, then asks best to worst, each level in time priority.
+struct BookSnapshot
+{
+    InstrumentId instrumentId_{ };
+    std::uint64_t journalSequence_{ };
+    Timestamp time_{ };
+    std::vector<SnapshotOrder> orders_;
+};
+
+// One book as seen through a mapped snapshot file; the orders are read in place.
+struct SnapshotBookView
+{
+    InstrumentId instrumentId_{ };
+    std::uint64_t journalSequence_{ };
+    Timestamp time_{ };
+    std::span<const SnapshotOrder> orders_;
+};
+
+// Writes `books` to `path` through a temporary file that is synced before it is renamed into place, and then syncs the
+// directory, so neither a crash nor power loss leaves a half-written snapshot under `path`.
+void WriteSnapshot(const std::string& path, std::span<const BookSnapshot> books); // Throws std::runtime_error.
+
+// Read-only, memory-mapped snapshot file.
+class SnapshotReader
+{
+private:
+    MappedFile file_;
+    std::vector<SnapshotBookView> books_;
+
+public:
+    explicit SnapshotReader(const std::string& path); // Throws std::runtime_error.
+    SnapshotReader(const SnapshotReader&) = delete;
+    void operator=(const SnapshotReader&) = delete;
+
+    std::span<const SnapshotBookView> Books() const { return books_; }
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+#include "Constants.h"
+
+// A bounded single-producer/single-consumer ring buffer.
+// Each side owns one index and keeps a cached copy of the other, so in steady state
+// push and pop touch only their own cache line.
+template<typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(std::size_t capacity)
+        : buffer_(std::bit_ceil(capacity < 2 ? std::size_t{ 2 } : capacity))
+        , mask_{ buffer_.size() - 1 }
+    { }
+
+    SpscRing(const SpscRing&) = delete;
+    void operator=(const SpscRing&) = delete;
+
+    // Producer side: returns false instead of blocking when the ring is full.
+    bool TryPush(const T& value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - cachedHead_ == buffer_.size())
+        {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == buffer_.size())
+                return false;
+        }
+
+        buffer_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: returns false when the ring is empty.
+    bool TryPop(T& value)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+
+        if (head == cachedTail_)
+        {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_)
+                return false;
+        }
+
+        value = buffer_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t Capacity() const { return buffer_.size(); }
+
+private:
+    std::vector<T> buffer_;
+    std::size_t mask_;
+
+    alignas(Constants::CacheLineSize) std::atomic<std::size_t> head_{ 0 };
+    std::size_t cachedTail_{ 0 }; // Consumer's view of `tail_`.
+
+    alignas(Constants::CacheLineSize) std::atomic<std::size_t> tail_{ 0 };
+    std::size_t cachedHead_{ 0 }; // Producer's view of `head_`.
+};
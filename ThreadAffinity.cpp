@@ -0,0 +1,52 @@
+#include "ThreadAffinity.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+
+#include <filesystem>
+#include <string>
+#endif
+
+bool PinCurrentThread(int cpu)
+{
+    if (cpu < 0)
+        return false;
+
+#if defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{ 1 } << cpu) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+    return false;
+#endif
+}
+
+int NumaNodeOfCpu(int cpu)
+{
+    if (cpu < 0)
+        return -1;
+
+#if defined(_WIN32)
+    UCHAR node = 0;
+    return cpu < 64 && GetNumaProcessorNode(static_cast<UCHAR>(cpu), &node) && node != 0xFF ? node : -1;
+#elif defined(__linux__)
+    // sysfs lists each CPU's node as a `nodeN` entry in the CPU's directory
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator{ "/sys/devices/system/cpu/cpu" + std::to_string(cpu), error })
+    {
+        const auto name = entry.path().filename().string();
+        if (name.size() > 4 && name.starts_with("node") && name.find_first_not_of("0123456789", 4) == std::string::npos)
+            return std::stoi(name.substr(4));
+    }
+
+    return -1;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Pins the calling thread to one logical CPU. Returns false if the platform refused or is unsupported.
+bool PinCurrentThread(int cpu);
+
+// NUMA node a logical CPU belongs to, or -1 if the platform does not say.
+int NumaNodeOfCpu(int cpu);
@@ -1,8 +1,35 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 
-using Price = std::int32_t;
-using Quantity = std::uint32_t;
-using OrderId = std::uint64_t;
-using OrderIds = std::vector<OrderId>;
\ No newline at end of file
+// Integer widths of the book's core types. A deployment picks one set for the whole build with
+// -DORDERBOOK_WIDTHS=<set>; narrower types shrink every resting order, the ID index and every level.
+// Journals, snapshots and the wire protocol keep their fixed field widths whatever the set.
+template<typename PriceType, typename QuantityType, typename OrderIdType>
+struct OrderbookWidths
+{
+    using Price = PriceType;
+    using Quantity = QuantityType;
+    using OrderId = OrderIdType;
+};
+
+using StandardWidths = OrderbookWidths<std::int32_t, std::uint32_t, std::uint64_t>; // The default.
+using CompactWidths = OrderbookWidths<std::int32_t, std::uint32_t, std::uint32_t>;  // Venues whose order IDs fit in 32 bits.
+
+#ifndef ORDERBOOK_WIDTHS
+#define ORDERBOOK_WIDTHS StandardWidths
+#endif
+
+using Widths = ORDERBOOK_WIDTHS;
+
+using Price = Widths::Price;
+using Quantity = Widths::Quantity;
+using OrderId = Widths::OrderId;
+
+static_assert(sizeof(Price) <= 4 && sizeof(Quantity) <= 4 && sizeof(OrderId) <= 8,
+    "Journals, snapshots and the wire protocol carry 32-bit prices and quantities and 64-bit order IDs.");
+
+using OrderIds = std::vector<OrderId>;
+using InstrumentId = std::uint32_t;
+using Timestamp = std::int64_t; // Nanoseconds since the Unix epoch.
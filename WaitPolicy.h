@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// How an engine thread waits while its inbound ring is empty.
+enum class WaitMode
+{
+    BusySpin,      // Never leaves the CPU or enters the kernel; polls with a pause hint in between. Costs a whole core.
+    SpinThenYield, // Spins for `WaitPolicy::spins_` empty polls, then yields the CPU between polls.
+    Blocking,      // Spins the same way, then sleeps until a producer wakes it or `WaitPolicy::sleep_` passes.
+};
+
+// Construction-time wait behaviour of one engine thread.
+struct WaitPolicy
+{
+    WaitMode mode_{ WaitMode::SpinThenYield };
+    std::uint32_t spins_{ 1000 };                 // Empty polls spent spinning before yielding or sleeping.
+    std::chrono::microseconds sleep_{ 1000 };     // Blocking only: longest sleep, which bounds how late clock-driven expiry can run.
+};
+
+// Tells the core this thread is spinning, so a sibling hyperthread gets the pipeline and the exit from the loop is cheap.
+inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Carries out a `WaitPolicy` for one consumer thread. The consumer calls `Idle` after every empty poll and `Reset`
+// once it finds work; producers call `Notify` after publishing, which does nothing unless the policy can block.
+class IdleWaiter
+{
+public:
+    explicit IdleWaiter(const WaitPolicy& policy) : policy_{ policy } { }
+    IdleWaiter(const IdleWaiter&) = delete;
+    void operator=(const IdleWaiter&) = delete;
+
+    // Consumer: waits once as the policy says. `ready` is checked after a blocking consumer announces its sleep,
+    // so work published in between is never slept through.
+    template<typename Ready>
+    void Idle(Ready&& ready)
+    {
+        if (policy_.mode_ == WaitMode::BusySpin || idlePolls_ < policy_.spins_)
+        {
+            ++idlePolls_;
+            CpuRelax();
+            return;
+        }
+
+        if (policy_.mode_ == WaitMode::SpinThenYield)
+        {
+            std::this_thread::yield();
+            return;
+        }
+
+        std::unique_lock lock{ mutex_ };
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready())
+            wake_.wait_for(lock, policy_.sleep_, [this] { return !sleeping_.load(std::memory_order_relaxed); });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+
+    // Consumer: found work, so the next idle spell starts with spinning again.
+    void Reset() { idlePolls_ = 0; }
+
+    // Producer: wakes a sleeping consumer; must follow the publish it announces.
+    void Notify()
+    {
+        if (policy_.mode_ != WaitMode::Blocking)
+            return;
+
+        // Pairs with the consumer's fence: either it sees the new work or this sees it sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!sleeping_.load(std::memory_order_relaxed))
+            return;
+
+        {
+            std::scoped_lock lock{ mutex_ };
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+        wake_.notify_one();
+    }
+
+    const WaitPolicy& GetPolicy() const { return policy_; }
+
+private:
+    WaitPolicy policy_;
+    std::uint32_t idlePolls_{ 0 }; // Consumer-owned count of empty polls in the current idle spell.
+    std::atomic<bool> sleeping_{ false }; // Set while a blocking consumer is, or is about to be, asleep.
+    std::mutex mutex_;
+    std::condition_variable wake_;
+};
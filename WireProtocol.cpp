@@ -0,0 +1,275 @@
+#include "WireProtocol.h"
+#include "Orderbook.h"
+
+#include <array>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+    // Field widths on the wire, fixed whatever integer widths the book was built with
+    using WireOrderId = std::uint64_t;
+    using WirePrice = std::int32_t;
+    using WireQuantity = std::uint32_t;
+
+    // Reads a big-endian integer from an unaligned position in a receive buffer
+    template<typename T>
+    T Load(const std::byte* data)
+    {
+        std::make_unsigned_t<T> value = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+            value = static_cast<std::make_unsigned_t<T>>((value << 8) | std::to_integer<std::uint8_t>(data[i]));
+
+        return static_cast<T>(value);
+    }
+
+    // Appends a big-endian integer to an outbound buffer
+    template<typename T>
+    void Store(std::vector<std::byte>& out, T value)
+    {
+        const auto bits = static_cast<std::make_unsigned_t<T>>(value);
+        for (std::size_t i = sizeof(T); i-- > 0;)
+            out.push_back(static_cast<std::byte>((bits >> (i * 8)) & 0xFF));
+    }
+
+    void Store(std::vector<std::byte>& out, WireMessageType type)
+    {
+        out.push_back(static_cast<std::byte>(type));
+    }
+
+    std::uint8_t ToWire(Side side) { return side == Side::Buy ? 'B' : 'S'; }
+
+    bool FromWire(std::uint8_t wire, Side& side)
+    {
+        if (wire != 'B' && wire != 'S')
+            return false;
+
+        side = wire == 'B' ? Side::Buy : Side::Sell;
+        return true;
+    }
+
+    // The wire always carries 64-bit IDs; one that does not fit the build's `OrderId` could alias a live order
+    bool FromWire(WireOrderId wire, OrderId& orderId)
+    {
+        if (wire > std::numeric_limits<OrderId>::max())
+            return false;
+
+        orderId = static_cast<OrderId>(wire);
+        return true;
+    }
+
+    // Length of an inbound message, or 0 for a type the engine does not accept
+    std::size_t InboundLength(WireMessageType type)
+    {
+        switch (type)
+        {
+        case WireMessageType::EnterOrder: return WireLength::EnterOrder;
+        case WireMessageType::CancelOrder: return WireLength::CancelOrder;
+        case WireMessageType::ReplaceOrder: return WireLength::ReplaceOrder;
+        case WireMessageType::CancelDay: return WireLength::CancelDay;
+        case WireMessageType::Time: return WireLength::Time;
+        default: return 0;
+        }
+    }
+}
+
+// Function to decode whole messages in place, straight into caller-provided commands
+WireDecodeResult DecodeCommands(std::span<const std::byte> buffer, std::span<Command> commands)
+{
+    WireDecodeResult result;
+
+    while (result.consumed_ < buffer.size() && result.decoded_ < commands.size())
+    {
+        const auto* message = buffer.data() + result.consumed_;
+        const auto type = static_cast<WireMessageType>(message[0]);
+        const auto length = InboundLength(type);
+
+        if (length == 0)
+        {
+            result.malformed_ = true;
+            break;
+        }
+
+        // Leave a partial message for the next read
+        if (buffer.size() - result.consumed_ < length)
+            break;
+
+        auto& command = commands[result.decoded_];
+        switch (type)
+        {
+        case WireMessageType::EnterOrder:
+        {
+            const auto orderType = Load<std::uint8_t>(message + 1);
+            Side side;
+            OrderId orderId;
+            if (orderType > static_cast<std::uint8_t>(OrderType::GoodTillDate) || !FromWire(Load<std::uint8_t>(message + 2), side)
+                || !FromWire(Load<WireOrderId>(message + 7), orderId))
+            {
+                result.malformed_ = true;
+                return result;
+            }
+
+            command = Command{ CommandType::Add, static_cast<OrderType>(orderType), side, Load<InstrumentId>(message + 3),
+                orderId, static_cast<Price>(Load<WirePrice>(message + 15)),
+                static_cast<Quantity>(Load<WireQuantity>(message + 19)), Load<Timestamp>(message + 23),
+                static_cast<Quantity>(Load<WireQuantity>(message + 31)) };
+            break;
+        }
+        case WireMessageType::CancelOrder:
+        {
+            OrderId orderId;
+            if (!FromWire(Load<WireOrderId>(message + 5), orderId))
+            {
+                result.malformed_ = true;
+                return result;
+            }
+
+            command = Command::Cancel(orderId, Load<InstrumentId>(message + 1));
+            break;
+        }
+        case WireMessageType::ReplaceOrder:
+        {
+            Side side;
+            OrderId orderId;
+            if (!FromWire(Load<std::uint8_t>(message + 1), side) || !FromWire(Load<WireOrderId>(message + 6), orderId))
+            {
+                result.malformed_ = true;
+                return result;
+            }
+
+            command = Command{ CommandType::Modify, OrderType::GoodTillCancel, side, Load<InstrumentId>(message + 2),
+                orderId, static_cast<Price>(Load<WirePrice>(message + 14)),
+                static_cast<Quantity>(Load<WireQuantity>(message + 18)) };
+            break;
+        }
+        case WireMessageType::CancelDay:
+            command = Command::CancelGoodForDay();
+            break;
+        default:
+            command = Command::AdvanceTime(Load<Timestamp>(message + 1));
+            break;
+        }
+
+        result.consumed_ += length;
+        ++result.decoded_;
+    }
+
+    return result;
+}
+
+// Function to turn one datagram into one batch against a book
+WireDecodeResult ExecuteDatagram(Orderbook& orderbook, std::span<const std::byte> datagram, ExecutionSink& sink)
+{
+    // Enough for a full jumbo frame of the smallest order messages; larger buffers are applied in several batches
+    std::array<Command, 1024> commands;
+    WireDecodeResult total;
+
+    while (true)
+    {
+        const auto result = DecodeCommands(datagram.subspan(total.consumed_), commands);
+        if (result.decoded_ != 0)
+            orderbook.Execute(std::span{ commands.data(), result.decoded_ }, sink);
+
+        total.consumed_ += result.consumed_;
+        total.decoded_ += result.decoded_;
+        total.malformed_ = result.malformed_;
+
+        if (result.decoded_ < commands.size() || result.malformed_)
+            return total;
+    }
+}
+
+// Function to encode a command as the inbound message a gateway would send
+void EncodeCommand(const Command& command, std::vector<std::byte>& out)
+{
+    switch (command.type_)
+    {
+    case CommandType::Add:
+        Store(out, WireMessageType::EnterOrder);
+        Store(out, static_cast<std::uint8_t>(command.orderType_));
+        Store(out, ToWire(command.side_));
+        Store(out, command.instrumentId_);
+        Store(out, static_cast<WireOrderId>(command.orderId_));
+        Store(out, static_cast<WirePrice>(command.price_));
+        Store(out, static_cast<WireQuantity>(command.quantity_));
+        Store(out, command.timestamp_);
+        Store(out, static_cast<WireQuantity>(command.displayQuantity_));
+        break;
+    case CommandType::Cancel:
+        Store(out, WireMessageType::CancelOrder);
+        Store(out, command.instrumentId_);
+        Store(out, static_cast<WireOrderId>(command.orderId_));
+        break;
+    case CommandType::Modify:
+        Store(out, WireMessageType::ReplaceOrder);
+        Store(out, ToWire(command.side_));
+        Store(out, command.instrumentId_);
+        Store(out, static_cast<WireOrderId>(command.orderId_));
+        Store(out, static_cast<WirePrice>(command.price_));
+        Store(out, static_cast<WireQuantity>(command.quantity_));
+        break;
+    case CommandType::CancelGoodForDay:
+        Store(out, WireMessageType::CancelDay);
+        break;
+    case CommandType::AdvanceTime:
+        Store(out, WireMessageType::Time);
+        Store(out, command.timestamp_);
+        break;
+    }
+}
+
+// Function to encode a fill as an `Executed` message
+void EncodeTrade(const Trade& trade, InstrumentId instrumentId, std::vector<std::byte>& out)
+{
+    Store(out, WireMessageType::Executed);
+    Store(out, instrumentId);
+    Store(out, static_cast<WireOrderId>(trade.GetBidTrade().orderId_));
+    Store(out, static_cast<WirePrice>(trade.GetBidTrade().price_));
+    Store(out, static_cast<WireOrderId>(trade.GetAskTrade().orderId_));
+    Store(out, static_cast<WirePrice>(trade.GetAskTrade().price_));
+    Store(out, static_cast<WireQuantity>(trade.GetBidTrade().quantity_));
+}
+
+// Function to encode an L2 delta as a `Level` message
+void EncodeLevelUpdate(const LevelUpdate& update, InstrumentId instrumentId, std::vector<std::byte>& out)
+{
+    Store(out, WireMessageType::Level);
+    Store(out, ToWire(update.side_));
+    Store(out, instrumentId);
+    Store(out, static_cast<WirePrice>(update.price_));
+    Store(out, static_cast<WireQuantity>(update.quantity_));
+    Store(out, static_cast<WireQuantity>(update.count_));
+}
+
+// Function to encode a reject as a `Rejected` message carrying its code
+void EncodeReject(OrderId orderId, RejectReason reason, InstrumentId instrumentId, std::vector<std::byte>& out)
+{
+    Store(out, WireMessageType::Rejected);
+    Store(out, static_cast<std::uint8_t>(reason));
+    Store(out, instrumentId);
+    Store(out, static_cast<WireOrderId>(orderId));
+}
+
+// Function to encode an engine output, naming acknowledged commands by their inbound message type
+void EncodeEvent(const EngineEvent& event, std::vector<std::byte>& out)
+{
+    if (event.type_ == EngineEventType::Trade)
+    {
+        EncodeTrade(event.ToTrade(), event.instrumentId_, out);
+        return;
+    }
+
+    if (event.type_ == EngineEventType::Reject)
+    {
+        EncodeReject(event.orderId_, event.reject_, event.instrumentId_, out);
+        return;
+    }
+
+    static constexpr std::array<WireMessageType, 5> acknowledged{ WireMessageType::EnterOrder, WireMessageType::CancelOrder,
+        WireMessageType::ReplaceOrder, WireMessageType::CancelDay, WireMessageType::Time };
+
+    Store(out, WireMessageType::Accepted);
+    Store(out, acknowledged[static_cast<std::size_t>(event.command_)]);
+    Store(out, event.instrumentId_);
+    Store(out, static_cast<WireOrderId>(event.orderId_));
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Usings.h"
+#include "Command.h"
+#include "EngineEvent.h"
+#include "ExecutionSink.h"
+#include "MarketDataSink.h"
+
+class Orderbook;
+
+// Fixed-layout binary messages in network byte order. Each message starts with a one-character type and
+// has a length fully determined by that type, so a datagram is simply messages back to back.
+//
+// Inbound (gateway to engine):
+//   'O' EnterOrder      type u8, orderType u8, side u8 ('B'/'S'), instrument u32, order u64, price i32, quantity u32, expiry i64, display u32
+//   'X' CancelOrder     type u8, instrument u32, order u64
+//   'U' ReplaceOrder    type u8, side u8, instrument u32, order u64, price i32, quantity u32
+//   'G' CancelDay       type u8
+//   'T' Time            type u8, timestamp i64
+// Outbound (engine to gateway):
+//   'A' Accepted        type u8, inbound type u8, instrument u32, order u64
+//   'J' Rejected        type u8, reason u8 (`RejectReason`), instrument u32, order u64
+//   'E' Executed        type u8, instrument u32, bid order u64, bid price i32, ask order u64, ask price i32, quantity u32
+//   'L' Level           type u8, side u8, instrument u32, price i32, quantity u32, count u32
+enum class WireMessageType : std::uint8_t
+{
+    EnterOrder = 'O',
+    CancelOrder = 'X',
+    ReplaceOrder = 'U',
+    CancelDay = 'G',
+    Time = 'T',
+    Accepted = 'A',
+    Rejected = 'J',
+    Executed = 'E',
+    Level = 'L',
+};
+
+// Length in bytes of each message, including its type.
+struct WireLength
+{
+    static constexpr std::size_t EnterOrder = 35;
+    static constexpr std::size_t CancelOrder = 13;
+    static constexpr std::size_t ReplaceOrder = 22;
+    static constexpr std::size_t CancelDay = 1;
+    static constexpr std::size_t Time = 9;
+    static constexpr std::size_t Accepted = 14;
+    static constexpr std::size_t Rejected = 14;
+    static constexpr std::size_t Executed = 33;
+    static constexpr std::size_t Level = 18;
+};
+
+// How far decoding a buffer got.
+struct WireDecodeResult
+{
+    std::size_t consumed_{ }; // Bytes of whole messages decoded.
+    std::size_t decoded_{ };  // Commands produced.
+    bool malformed_{ false }; // Decoding stopped at a message it did not recognise, or whose order ID does not fit `OrderId`.
+};
+
+// Decodes messages from `buffer` straight into `commands` until either runs out. A trailing partial message is left
+// unconsumed so a stream reader can carry it over; nothing is allocated.
+WireDecodeResult DecodeCommands(std::span<const std::byte> buffer, std::span<Command> commands);
+
+// Decodes one datagram and applies it to `orderbook` as a single batch.
+WireDecodeResult ExecuteDatagram(Orderbook& orderbook, std::span<const std::byte> datagram, ExecutionSink& sink);
+
+// Encoders append one message to a caller-owned buffer that is reused across datagrams.
+void EncodeCommand(const Command& command, std::vector<std::byte>& out); // Gateway side of the inbound messages.
+void EncodeTrade(const Trade& trade, InstrumentId instrumentId, std::vector<std::byte>& out);
+void EncodeLevelUpdate(const LevelUpdate& update, InstrumentId instrumentId, std::vector<std::byte>& out);
+void EncodeReject(OrderId orderId, RejectReason reason, InstrumentId instrumentId, std::vector<std::byte>& out);
+void EncodeEvent(const EngineEvent& event, std::vector<std::byte>& out); // An `Executed`, `Rejected` or `Accepted` message.
+
+// Sink that encodes each fill as an `Executed` message and each reject as a `Rejected` message.
+class WireExecutionEncoder final : public ExecutionSink
+{
+public:
+    WireExecutionEncoder(std::vector<std::byte>& out, InstrumentId instrumentId = { }) : out_{ out }, instrumentId_{ instrumentId } { }
+
+    void OnTrade(const Trade& trade) override { EncodeTrade(trade, instrumentId_, out_); }
+    void OnReject(OrderId orderId, RejectReason reason) override { EncodeReject(orderId, reason, instrumentId_, out_); }
+
+private:
+    std::vector<std::byte>& out_;
+    InstrumentId instrumentId_;
+};
+
+// Sink that encodes each L2 delta as a `Level` message.
+class WireMarketDataEncoder final : public MarketDataSink
+{
+public:
+    WireMarketDataEncoder(std::vector<std::byte>& out, InstrumentId instrumentId = { }) : out_{ out }, instrumentId_{ instrumentId } { }
+
+    void OnLevelUpdate(const LevelUpdate& update) override { EncodeLevelUpdate(update, instrumentId_, out_); }
+
+private:
+    std::vector<std::byte>& out_;
+    InstrumentId instrumentId_;
+};
@@ -1,8 +1,14 @@
-#pragma once
+#include <iostream>
 
-#include <vector>
+#include "Orderbook.h"
 
-using Price = std::int32_t;
-using Quantity = std::uint32_t;
-using OrderId = std::uint64_t;
-using OrderIds = std::vector<OrderId>;
\ No newline at end of file
+int main()
+{
+    Orderbook orderbook;
+
+    orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 1, Side::Buy, 100, 10 });
+    const auto trades = orderbook.AddOrder(Order{ OrderType::GoodTillCancel, 2, Side::Sell, 100, 4 });
+
+    std::cout << "Trades: " << trades.size() << ", resting orders: " << orderbook.Size() << std::endl;
+    return 0;
+}